@@ -65,6 +65,7 @@ constexpr char IDENT_RELTYPE    = SNAPSHOT ? 'S' : (BETA ? 'B' : 'R');
 constexpr char LOCAL_SAVE_DIR[] = "Saves";
 constexpr char STAMPS_DIR[]     = "stamps";
 constexpr char BRUSH_DIR[]      = "Brushes";
+constexpr char THUMBNAIL_DIR[]  = "thumbnails";
 
 constexpr int httpMaxConcurrentStreams = 50;
 constexpr int httpConnectTimeoutS      = 15;
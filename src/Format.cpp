@@ -1,12 +1,17 @@
+#include <algorithm>
+#include <array>
 #include <cstdint>
 #include <cstdio>
 #include <cstring>
 #include <ctime>
 #include <optional>
 #include <stdexcept>
+#include <thread>
 #include <png.h>
+#include <zlib.h>
 #include "Format.h"
 #include "graphics/VideoBuffer.h"
+#include "tasks/TaskPool.h"
 
 ByteString format::UnixtimeToDate(time_t unixtime, ByteString dateFormat, bool local)
 {
@@ -225,58 +230,217 @@ std::unique_ptr<PlaneAdapter<std::vector<pixel>>> format::PixelsFromPNG(std::spa
 	return readPNG(data, background);
 }
 
-std::unique_ptr<std::vector<char>> format::PixelsToPNG(PlaneAdapter<std::vector<pixel>> const &input)
+namespace
 {
-	png_infop info = nullptr;
-	auto deleter = [&info](png_struct *png) {
-		png_destroy_write_struct(&png, &info);
+	enum PNGFilter
+	{
+		pngFilterNone,
+		pngFilterSub,
+		pngFilterUp,
+		pngFilterAverage,
+		pngFilterPaeth,
+		pngFilterCount,
 	};
-	auto png = std::unique_ptr<png_struct, decltype(deleter)>(
-		png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr,
-			[](png_structp png, png_const_charp msg) {
-				fprintf(stderr, "PNG error: %s\n", msg);
-			},
-			[](png_structp png, png_const_charp msg) {
-				fprintf(stderr, "PNG warning: %s\n", msg);
-			}
-		), deleter
-	);
-	if (!png)
-		return nullptr;
 
-	// libpng might longjmp() here in case of error
-	// Every time we create an object with a non-trivial destructor we must call setjmp again
-	if (setjmp(png_jmpbuf(png.get())))
-		return nullptr;
+	// Bands smaller than this aren't worth a job of their own, and each band restarts the compressor's dictionary.
+	constexpr size_t minPNGBandSize = 128 * 1024;
+	constexpr int maxPNGBands = 8;
 
+	struct PNGBand
+	{
+		std::vector<unsigned char> data;
+		uLong adler;
+		bool ok = false;
+	};
 
-	info = png_create_info_struct(png.get());
-	if (!info)
-		return nullptr;
+	int Paeth(int a, int b, int c)
+	{
+		auto p = a + b - c;
+		auto pa = std::abs(p - a);
+		auto pb = std::abs(p - b);
+		auto pc = std::abs(p - c);
+		return (pa <= pb && pa <= pc) ? a : (pb <= pc ? b : c);
+	}
 
-	std::vector<char> output;
-	auto writeFn = [&output](png_structp png, png_bytep data, size_t length) {
-		output.insert(output.end(), data, data + length);
-	};
+	// Filters row, given the row above it in prior, into out, and returns the sum of the filtered bytes taken as
+	// signed values, which is the heuristic libpng uses to pick a filter for each row. Each filter gets its own loop
+	// so that the compiler can vectorize them.
+	int FilterPNGRow(int filter, const unsigned char *row, const unsigned char *prior, unsigned char *out, int length)
+	{
+		constexpr int bpp = 3;
+		switch (filter)
+		{
+		case pngFilterNone:
+			std::copy(row, row + length, out);
+			break;
 
-	std::vector<png_const_bytep> rowPointers(input.Size().Y);
-	for (int y = 0; y < input.Size().Y; y++)
-		rowPointers[y] = reinterpret_cast<png_const_bytep>(&*input.RowIterator(Vec2(0, y)));
+		case pngFilterSub:
+			std::copy(row, row + bpp, out);
+			for (int i = bpp; i < length; i++)
+				out[i] = row[i] - row[i - bpp];
+			break;
 
-	// See above
-	if (setjmp(png_jmpbuf(png.get())))
+		case pngFilterUp:
+			for (int i = 0; i < length; i++)
+				out[i] = row[i] - prior[i];
+			break;
+
+		case pngFilterAverage:
+			for (int i = 0; i < bpp; i++)
+				out[i] = row[i] - prior[i] / 2;
+			for (int i = bpp; i < length; i++)
+				out[i] = row[i] - (row[i - bpp] + prior[i]) / 2;
+			break;
+
+		case pngFilterPaeth:
+			for (int i = 0; i < bpp; i++)
+				out[i] = row[i] - prior[i];
+			for (int i = bpp; i < length; i++)
+				out[i] = row[i] - Paeth(row[i - bpp], prior[i], prior[i - bpp]);
+			break;
+		}
+		int sum = 0;
+		for (int i = 0; i < length; i++)
+			sum += std::abs(int(int8_t(out[i])));
+		return sum;
+	}
+
+	// Filters and compresses rows [begin, end) into raw deflate data that ends on a byte boundary, so that bands can
+	// simply be concatenated, and the last one with a final block.
+	PNGBand CompressPNGBand(PlaneAdapter<std::vector<pixel>> const &input, int begin, int end, bool last, format::PNGPreset preset)
+	{
+		PNGBand band;
+		auto length = input.Size().X * 3;
+		auto unpack = [&input, length](int y, unsigned char *out) {
+			for (int x = 0; x < input.Size().X; x++)
+			{
+				auto colour = RGB::Unpack(input[{ x, y }]);
+				out[x * 3    ] = colour.Red;
+				out[x * 3 + 1] = colour.Green;
+				out[x * 3 + 2] = colour.Blue;
+			}
+		};
+		std::vector<unsigned char> prior(length, 0), row(length), candidate(length);
+		if (begin > 0)
+			unpack(begin - 1, prior.data());
+		std::vector<unsigned char> filtered(size_t(end - begin) * (length + 1));
+		auto *out = filtered.data();
+		for (int y = begin; y < end; y++)
+		{
+			unpack(y, row.data());
+			if (preset == format::pngPresetFast)
+			{
+				out[0] = pngFilterSub;
+				FilterPNGRow(pngFilterSub, row.data(), prior.data(), out + 1, length);
+			}
+			else
+			{
+				int bestSum = FilterPNGRow(pngFilterNone, row.data(), prior.data(), out + 1, length);
+				out[0] = pngFilterNone;
+				for (int filter = pngFilterSub; filter < pngFilterCount; filter++)
+				{
+					auto sum = FilterPNGRow(filter, row.data(), prior.data(), candidate.data(), length);
+					if (sum < bestSum)
+					{
+						bestSum = sum;
+						out[0] = filter;
+						std::copy(candidate.begin(), candidate.end(), out + 1);
+					}
+				}
+			}
+			out += length + 1;
+			std::swap(row, prior);
+		}
+		band.adler = adler32(adler32(0, nullptr, 0), filtered.data(), uInt(filtered.size()));
+
+		auto level = preset == format::pngPresetFast ? 1 : (preset == format::pngPresetSmall ? 9 : Z_DEFAULT_COMPRESSION);
+		auto strategy = preset == format::pngPresetFast ? Z_DEFAULT_STRATEGY : Z_FILTERED;
+		z_stream stream{};
+		if (deflateInit2(&stream, level, Z_DEFLATED, -15, 8, strategy) != Z_OK)
+			return band;
+		// a sync flush adds an empty stored block on top of what deflateBound accounts for
+		band.data.resize(deflateBound(&stream, uLong(filtered.size())) + 16);
+		stream.next_in = filtered.data();
+		stream.avail_in = uInt(filtered.size());
+		stream.next_out = band.data.data();
+		stream.avail_out = uInt(band.data.size());
+		auto result = deflate(&stream, last ? Z_FINISH : Z_SYNC_FLUSH);
+		band.ok = (last ? result == Z_STREAM_END : result == Z_OK) && !stream.avail_in;
+		band.data.resize(stream.total_out);
+		deflateEnd(&stream);
+		return band;
+	}
+
+	void AppendBigEndian(std::vector<char> &output, uint32_t value)
+	{
+		for (int shift = 24; shift >= 0; shift -= 8)
+			output.push_back(char(value >> shift));
+	}
+
+	void AppendPNGChunk(std::vector<char> &output, const char (&type)[5], const unsigned char *data, size_t size)
+	{
+		AppendBigEndian(output, uint32_t(size));
+		auto start = output.size();
+		output.insert(output.end(), type, type + 4);
+		output.insert(output.end(), data, data + size);
+		auto crc = crc32(crc32(0, nullptr, 0), reinterpret_cast<const Bytef *>(output.data() + start), uInt(output.size() - start));
+		AppendBigEndian(output, uint32_t(crc));
+	}
+}
+
+std::unique_ptr<std::vector<char>> format::PixelsToPNG(PlaneAdapter<std::vector<pixel>> const &input, PNGPreset preset)
+{
+	// Written without libpng, which can only produce a single zlib stream from a single thread. Bands are compressed
+	// as raw deflate data that ends on a byte boundary, so they concatenate into one valid zlib stream, the way pigz
+	// does it; the header and the checksum of the whole stream are added here.
+	auto size = input.Size();
+	if (size.X <= 0 || size.Y <= 0)
 		return nullptr;
+	auto rowSize = size_t(size.X) * 3 + 1;
+	auto bandCount = int(std::clamp(std::min(rowSize * size.Y / minPNGBandSize, size_t(std::thread::hardware_concurrency())), size_t(1), size_t(maxPNGBands)));
+	auto bandRows = (size.Y + bandCount - 1) / bandCount;
+	bandCount = (size.Y + bandRows - 1) / bandRows;
+	std::vector<PNGBand> bands(bandCount);
+	auto compressBand = [&](int i) {
+		bands[i] = CompressPNGBand(input, i * bandRows, std::min((i + 1) * bandRows, size.Y), i == bandCount - 1, preset);
+	};
+	// On the TaskPool rather than on threads of their own; callers that are already running on the pool, such as
+	// FrameRecorder and ThumbnailRendererTask, compress bands themselves too while they wait.
+	TaskPool::Ref().Parallel(bandCount, compressBand, TaskPriority::normal);
 
-	png_set_write_fn(png.get(), static_cast<void *>(&writeFn), [](png_structp png, png_bytep data, size_t length) {
-		(*static_cast<decltype(writeFn) *>(png_get_io_ptr(png)))(png, data, length);
-	}, nullptr);
-	png_set_IHDR(png.get(), info, input.Size().X, input.Size().Y, 8, PNG_COLOR_TYPE_RGB, PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
-	png_write_info(png.get(), info);
-	png_set_filler(png.get(), 0x00, PNG_FILLER_AFTER);
-	png_set_bgr(png.get());
-	png_write_image(png.get(), const_cast<png_bytepp>(rowPointers.data()));
-	png_write_end(png.get(), nullptr);
+	auto adler = bands[0].adler;
+	for (int i = 0; i < bandCount; i++)
+	{
+		if (!bands[i].ok)
+			return nullptr;
+		if (i)
+			adler = adler32_combine(adler, bands[i].adler, (std::min((i + 1) * bandRows, size.Y) - i * bandRows) * rowSize);
+	}
+	// 32K window, deflate, with the level hint matching the preset
+	unsigned char cmf = 0x78;
+	unsigned char flg = (preset == pngPresetFast ? 0 : (preset == pngPresetSmall ? 3 : 2)) << 6;
+	flg += 31 - (cmf * 256 + flg) % 31;
+	bands[0].data.insert(bands[0].data.begin(), { cmf, flg });
+	for (int shift = 24; shift >= 0; shift -= 8)
+		bands.back().data.push_back((unsigned char)(adler >> shift));
 
+	std::vector<char> output;
+	static const char signature[] = "\x89PNG\r\n\x1A\n";
+	output.insert(output.end(), signature, signature + 8);
+	std::array<unsigned char, 13> header{};
+	for (int i = 0; i < 4; i++)
+	{
+		header[i    ] = (unsigned char)(uint32_t(size.X) >> (24 - 8 * i));
+		header[i + 4] = (unsigned char)(uint32_t(size.Y) >> (24 - 8 * i));
+	}
+	header[8] = 8; // bit depth
+	header[9] = 2; // truecolour, no alpha
+	AppendPNGChunk(output, "IHDR", header.data(), header.size());
+	for (auto &band : bands)
+	{
+		AppendPNGChunk(output, "IDAT", band.data.data(), band.data.size());
+	}
+	AppendPNGChunk(output, "IEND", nullptr, 0);
 	return std::make_unique<std::vector<char>>(std::move(output));
 }
 
@@ -25,8 +25,16 @@ namespace format
 	ByteString UnixtimeToDate(time_t unixtime, ByteString dateFomat = ByteString("%d %b %Y"), bool local = true);
 	ByteString UnixtimeToDateMini(time_t unixtime);
 	String CleanString(String dirtyString, bool ascii, bool color, bool newlines, bool numeric = false);
+	enum PNGPreset
+	{
+		pngPresetFast,    // Sub filter on every row and the fastest zlib level, for when many images need writing
+		pngPresetDefault, // per-row adaptive filtering and zlib's default level, close to what libpng does by default
+		pngPresetSmall,   // per-row adaptive filtering and the slowest zlib level
+	};
+
 	std::vector<char> PixelsToPPM(PlaneAdapter<std::vector<pixel>> const &);
-	std::unique_ptr<std::vector<char>> PixelsToPNG(PlaneAdapter<std::vector<pixel>> const &);
+	// Big images are split into bands of rows that are compressed in parallel, each into its own IDAT chunk.
+	std::unique_ptr<std::vector<char>> PixelsToPNG(PlaneAdapter<std::vector<pixel>> const &, PNGPreset preset = pngPresetDefault);
 	std::unique_ptr<PlaneAdapter<std::vector<pixel_rgba>>> PixelsFromPNG(std::span<const char> data);
 	std::unique_ptr<PlaneAdapter<std::vector<pixel>>> PixelsFromPNG(std::span<const char> data, RGB background);
 	void RenderTemperature(StringBuilder &sb, float temp, TempScale scale);
@@ -0,0 +1,380 @@
+#include "client/GameSave.h"
+#include "simulation/Simulation.h"
+#include "simulation/SimulationData.h"
+#include "simulation/Snapshot.h"
+#include "simulation/SnapshotDelta.h"
+#include "common/platform/Platform.h"
+#include "common/String.h"
+#include "common/Bson.h"
+#include "bzip2/bz2wrap.h"
+#include "Config.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <vector>
+
+// * Golden files live next to the saves they belong to, as <save>.golden, and are bzip2-compressed
+//   Bson documents holding the frame count, the final Snapshot::Hash64, the time each frame took,
+//   and the final Snapshot itself, so that a mismatch can be explained with a SnapshotDelta.
+// * Newtonian gravity is simulated with gravity/Null.cpp, same as in render: FFTW plans picked by
+//   measurement are not guaranteed to produce bit-identical results from one run to the next.
+
+constexpr int defaultFrames = 300;
+constexpr double slowerThreshold = 1.2;
+constexpr unsigned int rngSeed = 0;
+
+#define SNAPSHOT_VECTORS(X) \
+	X(AirPressure) \
+	X(AirVelocityX) \
+	X(AirVelocityY) \
+	X(AmbientHeat) \
+	X(Particles) \
+	X(GravForceX) \
+	X(GravForceY) \
+	X(GravMass) \
+	X(GravMask) \
+	X(BlockMap) \
+	X(ElecMap) \
+	X(BlockAir) \
+	X(BlockAirH) \
+	X(FanVelocityX) \
+	X(FanVelocityY) \
+	X(PortalParticles) \
+	X(WirelessData) \
+	X(stickmen)
+
+template<class Item>
+static Bson::User VectorToUser(const std::vector<Item> &vec)
+{
+	Bson::User user(vec.size() * sizeof(Item));
+	std::memcpy(user.data(), vec.data(), user.size());
+	return user;
+}
+
+template<class Item>
+static void VectorFromUser(std::vector<Item> &vec, const Bson::User &user)
+{
+	vec.resize(user.size() / sizeof(Item));
+	std::memcpy(vec.data(), user.data(), vec.size() * sizeof(Item));
+}
+
+template<class Item, size_t TileItems>
+static Bson::User VectorToUser(const SnapshotPlane<Item, TileItems> &plane)
+{
+	return VectorToUser(plane.ToVector());
+}
+
+template<class Item, size_t TileItems>
+static void VectorFromUser(SnapshotPlane<Item, TileItems> &plane, const Bson::User &user)
+{
+	std::vector<Item> vec;
+	VectorFromUser(vec, user);
+	plane.Assign(vec.data(), vec.size());
+}
+
+struct Golden
+{
+	int frames = 0;
+	uint64_t hash = 0;
+	std::vector<int64_t> frameTimes; // microseconds
+	std::unique_ptr<Snapshot> snap;
+};
+
+static std::optional<Golden> ReadGolden(ByteString path)
+{
+	std::vector<char> compressed;
+	if (!Platform::FileExists(path) || !Platform::ReadFile(compressed, path))
+	{
+		return std::nullopt;
+	}
+	std::vector<char> data;
+	if (BZ2WDecompress(data, compressed) != BZ2WDecompressOk)
+	{
+		std::cerr << path << ": failed to decompress" << std::endl;
+		return std::nullopt;
+	}
+	try
+	{
+		auto root = Bson::Parse(data);
+		Golden golden;
+		golden.frames = root.Get<Bson::Int32>("frames", 0);
+		golden.hash = uint64_t(root.Get<Bson::Int64>("hash64", 0));
+		if (auto *frameTimes = root.Get("frameTimes"))
+		{
+			for (auto &frameTime : frameTimes->As<Bson::Array>())
+			{
+				golden.frameTimes.push_back(frameTime.As<Bson::Int64>());
+			}
+		}
+		golden.snap = std::make_unique<Snapshot>();
+		auto &snapNode = root["snapshot"];
+#define READ_VECTOR(name) VectorFromUser(golden.snap->name, snapNode.Get<Bson::User>(#name, {}));
+		SNAPSHOT_VECTORS(READ_VECTOR)
+#undef READ_VECTOR
+		golden.snap->FrameCount = uint64_t(snapNode.Get<Bson::Int64>("FrameCount", 0));
+		golden.snap->RngState[0] = uint64_t(snapNode.Get<Bson::Int64>("RngState0", 0));
+		golden.snap->RngState[1] = uint64_t(snapNode.Get<Bson::Int64>("RngState1", 0));
+		return golden;
+	}
+	catch (const Bson::ParseError &ex)
+	{
+		std::cerr << path << ": " << ex.what() << std::endl;
+	}
+	return std::nullopt;
+}
+
+static bool WriteGolden(ByteString path, const Golden &golden)
+{
+	Bson root;
+	root["frames"] = Bson::Int32(golden.frames);
+	root["hash64"] = Bson::Int64(golden.hash);
+	root["frameTimes"] = Bson(Bson::Type::arrayValue);
+	for (auto frameTime : golden.frameTimes)
+	{
+		root["frameTimes"].Append(Bson::Int64(frameTime));
+	}
+	auto &snapNode = root["snapshot"];
+#define WRITE_VECTOR(name) snapNode[#name] = VectorToUser(golden.snap->name);
+	SNAPSHOT_VECTORS(WRITE_VECTOR)
+#undef WRITE_VECTOR
+	snapNode["FrameCount"] = Bson::Int64(golden.snap->FrameCount);
+	snapNode["RngState0"] = Bson::Int64(golden.snap->RngState[0]);
+	snapNode["RngState1"] = Bson::Int64(golden.snap->RngState[1]);
+	std::vector<char> compressed;
+	if (BZ2WCompress(compressed, root.Dump()) != BZ2WCompressOk)
+	{
+		std::cerr << path << ": failed to compress" << std::endl;
+		return false;
+	}
+	return Platform::WriteFile(compressed, path);
+}
+
+template<class Item>
+static void ReportHunks(const char *name, const SnapshotDelta::HunkVector<Item> &hunks, int itemsPerUnit, int width)
+{
+	if (hunks.empty())
+	{
+		return;
+	}
+	int units = 0;
+	int lastUnit = -1;
+	for (auto &hunk : hunks)
+	{
+		for (auto i = 0; i < int(hunk.diffs.size()); ++i)
+		{
+			auto unit = (hunk.offset + i) / itemsPerUnit;
+			if (unit != lastUnit)
+			{
+				units += 1;
+				lastUnit = unit;
+			}
+		}
+	}
+	auto first = hunks.front().offset / itemsPerUnit;
+	std::cout << "    " << name << ": " << units << " differ in " << hunks.size() << " hunks, first at ";
+	if (width)
+	{
+		std::cout << "(" << first % width << ", " << first / width << ")";
+	}
+	else
+	{
+		std::cout << "#" << first;
+	}
+	std::cout << std::endl;
+}
+
+static void ReportDelta(const Snapshot &golden, const Snapshot &current)
+{
+	auto delta = SnapshotDelta::FromSnapshots(golden, current);
+	ReportHunks("AirPressure"    , delta->AirPressure    , 1, XCELLS);
+	ReportHunks("AirVelocityX"   , delta->AirVelocityX   , 1, XCELLS);
+	ReportHunks("AirVelocityY"   , delta->AirVelocityY   , 1, XCELLS);
+	ReportHunks("AmbientHeat"    , delta->AmbientHeat    , 1, XCELLS);
+	ReportHunks("Particles"      , delta->commonParticles, sizeof(Particle) / sizeof(uint32_t), 0);
+	ReportHunks("GravMass"       , delta->GravMass       , 1, XCELLS);
+	ReportHunks("GravMask"       , delta->GravMask       , 1, XCELLS);
+	ReportHunks("GravForceX"     , delta->GravForceX     , 1, XCELLS);
+	ReportHunks("GravForceY"     , delta->GravForceY     , 1, XCELLS);
+	ReportHunks("BlockMap"       , delta->BlockMap       , 1, XCELLS);
+	ReportHunks("ElecMap"        , delta->ElecMap        , 1, XCELLS);
+	ReportHunks("BlockAir"       , delta->BlockAir       , 1, XCELLS);
+	ReportHunks("BlockAirH"      , delta->BlockAirH      , 1, XCELLS);
+	ReportHunks("FanVelocityX"   , delta->FanVelocityX   , 1, XCELLS);
+	ReportHunks("FanVelocityY"   , delta->FanVelocityY   , 1, XCELLS);
+	ReportHunks("PortalParticles", delta->PortalParticles, sizeof(Particle) / sizeof(uint32_t), 0);
+	ReportHunks("WirelessData"   , delta->WirelessData   , 2, 0);
+	ReportHunks("stickmen"       , delta->stickmen       , sizeof(playerst) / sizeof(uint32_t), 0);
+	if (delta->extraPartsOld.size() || delta->extraPartsNew.size())
+	{
+		std::cout << "    Particles: " << delta->extraPartsOld.size() << " only in golden, " << delta->extraPartsNew.size() << " only in current" << std::endl;
+	}
+	if (delta->FrameCount.valid)
+	{
+		std::cout << "    FrameCount: " << delta->FrameCount.diff.oldItem << " vs " << delta->FrameCount.diff.newItem << std::endl;
+	}
+	if (delta->RngState.valid)
+	{
+		std::cout << "    RngState differs" << std::endl;
+	}
+}
+
+static int64_t Total(const std::vector<int64_t> &frameTimes)
+{
+	int64_t total = 0;
+	for (auto frameTime : frameTimes)
+	{
+		total += frameTime;
+	}
+	return total;
+}
+
+static int64_t Median(std::vector<int64_t> frameTimes)
+{
+	if (frameTimes.empty())
+	{
+		return 0;
+	}
+	auto middle = frameTimes.begin() + frameTimes.size() / 2;
+	std::nth_element(frameTimes.begin(), middle, frameTimes.end());
+	return *middle;
+}
+
+int main(int argc, char *argv[])
+{
+	bool update = false;
+	std::vector<ByteString> args;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (ByteString(argv[i]) == "--update")
+		{
+			update = true;
+		}
+		else
+		{
+			args.push_back(argv[i]);
+		}
+	}
+	if (args.empty())
+	{
+		std::cout << "Usage: " << argv[0] << " [--update] <corpusDirectory> [frames]" << std::endl;
+		return 1;
+	}
+	auto corpus = args[0];
+	std::optional<int> framesOverride;
+	if (args.size() > 1)
+	{
+		try
+		{
+			framesOverride = args[1].ToNumber<int>();
+		}
+		catch (const std::runtime_error &)
+		{
+			std::cerr << "invalid frame count " << args[1] << std::endl;
+			return 1;
+		}
+	}
+
+	auto simulationData = std::make_unique<SimulationData>();
+	auto sim = Simulation::Factory();
+
+	auto saveNames = Platform::DirectorySearch(corpus, "", { ".cps", ".stm" });
+	std::sort(saveNames.begin(), saveNames.end());
+	int failed = 0;
+	for (auto &saveName : saveNames)
+	{
+		auto savePath = ByteString::Build(corpus, PATH_SEP_CHAR, saveName);
+		auto goldenPath = savePath + ".golden";
+		std::vector<char> fileData;
+		std::unique_ptr<GameSave> gameSave;
+		try
+		{
+			if (!Platform::ReadFile(fileData, savePath))
+			{
+				throw ParseException(ParseException::Corrupt, "cannot read file");
+			}
+			gameSave = std::make_unique<GameSave>(fileData, false);
+		}
+		catch (const ParseException &e)
+		{
+			std::cout << "FAIL " << saveName << ": " << e.what() << std::endl;
+			failed += 1;
+			continue;
+		}
+
+		auto golden = update ? std::nullopt : ReadGolden(goldenPath);
+		if (!update && !golden)
+		{
+			std::cout << "FAIL " << saveName << ": no golden file, run with --update to create one" << std::endl;
+			failed += 1;
+			continue;
+		}
+		auto frames = defaultFrames;
+		if (golden)
+		{
+			frames = golden->frames;
+		}
+		if (framesOverride)
+		{
+			frames = *framesOverride;
+		}
+
+		// same order as GameModel::SetSave
+		sim->LoadSimOptions(*gameSave);
+		if (!gameSave->hasRngState)
+		{
+			// LoadSimOptions picks a random seed for these, which would make every run different
+			sim->rng.seed(rngSeed);
+		}
+		sim->clear_sim();
+		sim->Load(gameSave.get(), true, { 0, 0 });
+
+		std::vector<int64_t> frameTimes;
+		for (int frame = 0; frame < frames; ++frame)
+		{
+			auto begin = std::chrono::steady_clock::now();
+			sim->BeforeSim(true);
+			sim->UpdateParticles(0, NPART);
+			sim->AfterSim();
+			auto end = std::chrono::steady_clock::now();
+			frameTimes.push_back(std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count());
+		}
+		auto snap = sim->CreateSnapshot();
+		auto hash = snap->Hash64(true);
+		auto total = Total(frameTimes);
+
+		if (update)
+		{
+			Golden newGolden{ frames, hash, frameTimes, std::move(snap) };
+			if (!WriteGolden(goldenPath, newGolden))
+			{
+				std::cout << "FAIL " << saveName << ": cannot write golden file" << std::endl;
+				failed += 1;
+				continue;
+			}
+			std::cout << "UPDATED " << saveName << ": " << frames << " frames, hash " << ByteString::Build(Format::Hex(), hash) << ", " << total / 1000 << "ms" << std::endl;
+			continue;
+		}
+
+		auto goldenTotal = Total(golden->frameTimes);
+		auto timing = ByteString::Build(total / 1000, "ms (median frame ", Median(frameTimes), "us) vs golden ", goldenTotal / 1000, "ms (median frame ", Median(golden->frameTimes), "us)");
+		if (frames != golden->frames)
+		{
+			std::cout << "DONE " << saveName << ": " << frames << " frames instead of the golden " << golden->frames << ", hash not compared, " << timing << std::endl;
+			continue;
+		}
+		if (hash != golden->hash)
+		{
+			std::cout << "FAIL " << saveName << ": hash " << ByteString::Build(Format::Hex(), hash) << " vs golden " << ByteString::Build(Format::Hex(), golden->hash) << ", " << timing << std::endl;
+			ReportDelta(*golden->snap, *snap);
+			failed += 1;
+			continue;
+		}
+		auto slower = goldenTotal && double(total) > double(goldenTotal) * slowerThreshold;
+		std::cout << (slower ? "SLOWER " : "OK ") << saveName << ": " << timing << std::endl;
+	}
+	std::cout << saveNames.size() - failed << "/" << saveNames.size() << " saves passed" << std::endl;
+	return failed ? 1 : 0;
+}
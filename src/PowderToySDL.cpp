@@ -7,7 +7,9 @@
 #include "common/platform/Platform.h"
 #include "common/clipboard/Clipboard.h"
 #include "FrameSchedule.h"
+#include <algorithm>
 #include <iostream>
+#include <vector>
 
 int desktopWidth = 1280;
 int desktopHeight = 1024;
@@ -33,6 +35,18 @@ static FrameSchedule drawSchedule;
 static FrameSchedule clientTickSchedule;
 static FrameSchedule fpsUpdateSchedule;
 
+// * blit compares each frame with the one it uploaded last and only uploads the rectangle that changed, and skips
+//   presenting altogether if nothing did, so that static screens cost next to nothing to display.
+// * forceFullBlit is set whenever what's on the screen may not match lastBlitFrame anymore, e.g. when the texture is
+//   recreated or the window is exposed.
+// * Whether anything changed is passed on to the Engine, which uses it to decide whether the next frame has to be
+//   drawn at all (see ui::Engine::NeedsDraw). Frames that don't have to be drawn are still drawn every
+//   idleDrawIntervalNs, so that a change the Engine isn't told about only goes unseen for that long.
+static std::vector<pixel> lastBlitFrame;
+static bool forceFullBlit = true;
+constexpr uint64_t idleDrawIntervalNs = UINT64_C(250'000'000);
+static uint64_t lastDrawNs = 0;
+
 void StartTextInput()
 {
 	SDL_StartTextInput();
@@ -104,14 +118,50 @@ static void CalculateMousePosition(int *x, int *y)
 		*y = (globalMy - windowY) / currentFrameOps.scale;
 }
 
-void blit(pixel *vid)
+bool blit(pixel *vid)
 {
-	SDL_UpdateTexture(sdl_texture, nullptr, vid, WINDOWW * sizeof (Uint32));
+	auto dirty = RectSized(Vec2{ 0, 0 }, WINDOW);
+	if (forceFullBlit || lastBlitFrame.empty())
+	{
+		lastBlitFrame.resize(WINDOWW * WINDOWH);
+		forceFullBlit = false;
+	}
+	else
+	{
+		int top = WINDOWH, bottom = -1, left = WINDOWW, right = -1;
+		for (int y = 0; y < WINDOWH; y++)
+		{
+			auto *row = vid + y * WINDOWW;
+			auto *lastRow = lastBlitFrame.data() + y * WINDOWW;
+			auto first = int(std::mismatch(row, row + WINDOWW, lastRow).first - row);
+			if (first == WINDOWW)
+			{
+				continue;
+			}
+			auto last = WINDOWW - 1 - int(std::mismatch(std::make_reverse_iterator(row + WINDOWW), std::make_reverse_iterator(row), std::make_reverse_iterator(lastRow + WINDOWW)).first - std::make_reverse_iterator(row + WINDOWW));
+			top = std::min(top, y);
+			bottom = y;
+			left = std::min(left, first);
+			right = std::max(right, last);
+		}
+		if (bottom < 0)
+		{
+			return false;
+		}
+		dirty = RectBetween(Vec2{ left, top }, Vec2{ right, bottom });
+	}
+	for (int y = dirty.pos.Y; y < dirty.pos.Y + dirty.size.Y; y++)
+	{
+		std::copy_n(vid + y * WINDOWW + dirty.pos.X, dirty.size.X, lastBlitFrame.data() + y * WINDOWW + dirty.pos.X);
+	}
+	SDL_Rect dirtyRect{ dirty.pos.X, dirty.pos.Y, dirty.size.X, dirty.size.Y };
+	SDL_UpdateTexture(sdl_texture, &dirtyRect, vid + dirty.pos.Y * WINDOWW + dirty.pos.X, WINDOWW * sizeof (Uint32));
 	// need to clear the renderer if there are black edges (fullscreen, or resizable window)
 	if (currentFrameOps.fullscreen || currentFrameOps.resizable)
 		SDL_RenderClear(sdl_renderer);
 	SDL_RenderCopy(sdl_renderer, sdl_texture, nullptr, nullptr);
 	SDL_RenderPresent(sdl_renderer);
+	return true;
 }
 
 void UpdateRefreshRate()
@@ -283,6 +333,7 @@ void SDLSetScreen()
 		SDL_RaiseWindow(sdl_window);
 		Clipboard::RecreateWindow();
 	}
+	forceFullBlit = true;
 	SDL_RenderSetIntegerScale(sdl_renderer, newFrameOpsNorm.forceIntegerScaling ? SDL_TRUE : SDL_FALSE);
 	if (!(newFrameOpsNorm.resizable && SDL_GetWindowFlags(sdl_window) & SDL_WINDOW_MAXIMIZED))
 	{
@@ -415,6 +466,8 @@ static void EventProcess(const SDL_Event &event)
 			UpdateRefreshRate();
 			break;
 		}
+		// anything that happens to the window may mean that it has to be presented again
+		forceFullBlit = true;
 		break;
 	}
 	}
@@ -484,10 +537,14 @@ std::optional<uint64_t> EngineProcess()
 	}
 	if (doDraw)
 	{
-		engine.Draw();
 		drawSchedule.SetNow(nowNs);
 		SDLSetScreen();
-		blit(engine.g->Data());
+		if (forceFullBlit || engine.NeedsDraw() || nowNs - lastDrawNs >= idleDrawIntervalNs)
+		{
+			engine.Draw();
+			lastDrawNs = nowNs;
+			engine.SetLastFrameChanged(blit(engine.g->Data()));
+		}
 	}
 	if (effectiveDrawLimit)
 	{
@@ -33,7 +33,7 @@ ByteString ClipboardPull();
 int GetModifiers();
 unsigned int GetTicks();
 uint64_t GetNowNs();
-void blit(pixel *vid);
+bool blit(pixel *vid); // returns whether anything was presented
 void SDLOpen();
 void SDLClose();
 void SDLSetScreen();
@@ -445,7 +445,9 @@ std::unique_ptr<SaveFile> Client::LoadSaveFile(ByteString filename)
 			std::vector<char> data;
 			if (Platform::ReadFile(data, filename))
 			{
+				auto contentHash = SaveFile::HashData(data);
 				file->SetGameSave(std::make_unique<GameSave>(std::move(data)));
+				file->SetContentHash(contentHash);
 			}
 			else
 			{
@@ -20,6 +20,7 @@ const GameSave *SaveFile::LazyGetGameSave() // non-owning
 			std::vector<char> data;
 			if (Platform::ReadFile(data, filename))
 			{
+				contentHash = HashData(data);
 				gameSave = std::make_unique<GameSave>(std::move(data));
 			}
 			else
@@ -56,6 +57,8 @@ void SaveFile::LazyUnload()
 void SaveFile::SetGameSave(std::unique_ptr<GameSave> newGameSave)
 {
 	gameSave = std::move(newGameSave);
+	// whatever the hash was of, it wasn't this save
+	contentHash = 0;
 }
 
 const ByteString &SaveFile::GetName() const
@@ -87,3 +90,25 @@ void SaveFile::SetLoadingError(String error)
 {
 	loadingError = error;
 }
+
+uint64_t SaveFile::GetContentHash() const
+{
+	return contentHash;
+}
+
+void SaveFile::SetContentHash(uint64_t newContentHash)
+{
+	contentHash = newContentHash;
+}
+
+uint64_t SaveFile::HashData(std::span<const char> data)
+{
+	// http://www.isthe.com/chongo/tech/comp/fnv/
+	auto hash = UINT64_C(14695981039346656037);
+	for (auto ch : data)
+	{
+		hash ^= uint8_t(ch);
+		hash *= UINT64_C(1099511628211);
+	}
+	return hash;
+}
@@ -1,6 +1,8 @@
 #pragma once
 #include "common/String.h"
+#include <cstdint>
 #include <memory>
+#include <span>
 
 class GameSave;
 
@@ -11,13 +13,17 @@ public:
 	const GameSave *LazyGetGameSave();
 	const GameSave *GetGameSave() const;
 	std::unique_ptr<GameSave> TakeGameSave();
-	void SetGameSave(std::unique_ptr<GameSave> newSameSave);
+	void SetGameSave(std::unique_ptr<GameSave> newSameSave); // also resets the content hash
 	const String &GetDisplayName() const;
 	void SetDisplayName(String displayName);
 	const ByteString &GetName() const;
 	void SetFileName(ByteString fileName);
 	const String &GetError() const;
 	void SetLoadingError(String error);
+	uint64_t GetContentHash() const;
+	void SetContentHash(uint64_t newContentHash);
+
+	static uint64_t HashData(std::span<const char> data);
 
 	void LazyUnload();
 private:
@@ -25,5 +31,6 @@ private:
 	ByteString filename;
 	String displayName;
 	String loadingError;
+	uint64_t contentHash = 0; // of the file the save was loaded from, 0 if unknown
 	bool lazyLoad;
 };
@@ -1,24 +1,104 @@
 #include "ThumbnailRendererTask.h"
 
+#include <algorithm>
 #include <cmath>
+#include <ctime>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
 
 #include "graphics/VideoBuffer.h"
 #include "simulation/SaveRenderer.h"
 #include "client/GameSave.h"
+#include "client/SaveFile.h"
+#include "common/platform/Platform.h"
+#include "Config.h"
 
-int ThumbnailRendererTask::queueSize = 0;
+std::atomic<int> ThumbnailRendererTask::queueSize = 0;
+
+namespace
+{
+	// Once the cache holds more than maxCacheEntries thumbnails, the ones used longest ago are removed until it holds
+	// pruneCacheTo; hits refresh the modification time, so that is the time of last use. At a few kilobytes per
+	// thumbnail, this keeps it in the tens of megabytes.
+	constexpr size_t maxCacheEntries = 4000;
+	constexpr size_t pruneCacheTo = 3000;
+	// listing the cache isn't free, so it's only checked on the first write and then every this many writes
+	constexpr int writesPerPruneCheck = 100;
+	// temporary files this old were left behind by a writer that never got to move them into place
+	constexpr int64_t staleTempAge = 3600;
+
+	std::mutex cacheMx;
+	int cacheWrites = 0;
+
+	void PruneCache()
+	{
+		auto now = int64_t(time(nullptr));
+		for (auto &name : Platform::DirectorySearch(THUMBNAIL_DIR, "", { ".tmp" }))
+		{
+			auto path = ByteString::Build(THUMBNAIL_DIR, PATH_SEP_CHAR, name);
+			auto modified = Platform::LastModified(path);
+			if (modified && now - *modified > staleTempAge)
+			{
+				Platform::RemoveFile(path);
+			}
+		}
+		auto names = Platform::DirectorySearch(THUMBNAIL_DIR, "", { ".png" });
+		if (names.size() <= maxCacheEntries)
+		{
+			return;
+		}
+		std::vector<std::pair<int64_t, ByteString>> entries;
+		for (auto &name : names)
+		{
+			auto path = ByteString::Build(THUMBNAIL_DIR, PATH_SEP_CHAR, name);
+			if (auto modified = Platform::LastModified(path))
+			{
+				entries.push_back({ *modified, path });
+			}
+		}
+		std::sort(entries.begin(), entries.end());
+		for (size_t i = 0; i + pruneCacheTo < entries.size(); i++)
+		{
+			Platform::RemoveFile(entries[i].second);
+		}
+	}
+
+	void WriteCacheEntry(std::span<const char> data, ByteString path)
+	{
+		Platform::MakeDirectory(THUMBNAIL_DIR);
+		// Other workers may be reading path, so the thumbnail is written under a name that only this thread uses and
+		// then moved into place. That name is cleared first so that WriteFile never takes its replace path, which
+		// needs interfaceRng and is thus only safe on the main thread.
+		auto tempPath = ByteString::Build(path, '.', Format::Hex(), std::hash<std::thread::id>()(std::this_thread::get_id()), ".tmp");
+		Platform::RemoveFile(tempPath);
+		if (Platform::WriteFile(data, tempPath) && !Platform::RenameFile(tempPath, path, true))
+		{
+			Platform::RemoveFile(tempPath);
+		}
+		std::lock_guard lk(cacheMx);
+		if (cacheWrites++ % writesPerPruneCheck == 0)
+		{
+			PruneCache();
+		}
+	}
+}
 
 int ThumbnailRendererTask::QueueSize()
 {
 	return queueSize;
 }
 
-ThumbnailRendererTask::ThumbnailRendererTask(GameSave const &save, Vec2<int> size, RendererSettings::DecorationLevel newDecorationLevel, bool fire):
+ThumbnailRendererTask::ThumbnailRendererTask(GameSave const &save, Vec2<int> size, RendererSettings::DecorationLevel newDecorationLevel, bool fire, uint64_t newContentHash):
 	save(std::make_unique<GameSave>(save)),
 	size(size),
 	decorationLevel(newDecorationLevel),
-	fire(fire)
+	fire(fire),
+	contentHash(newContentHash)
 {
+	// thumbnails come in bulk and nobody is waiting on any single one of them
+	priority = TaskPriority::low;
 	queueSize += 1;
 }
 
@@ -27,8 +107,31 @@ ThumbnailRendererTask::~ThumbnailRendererTask()
 	queueSize -= 1;
 }
 
+ByteString ThumbnailRendererTask::CachePath() const
+{
+	// everything that affects the output goes into the file name; stale entries are simply never hit again
+	auto key = ByteString::Build(contentHash, ' ', size.X, ' ', size.Y, ' ', int(decorationLevel), ' ', fire, ' ', APP_VERSION.build);
+	return ByteString::Build(THUMBNAIL_DIR, PATH_SEP_CHAR, Format::Hex(), Format::Width(16), Format::Fill('0'), SaveFile::HashData(key), ".png");
+}
+
 bool ThumbnailRendererTask::doWork()
 {
+	ByteString cachePath;
+	if (contentHash)
+	{
+		cachePath = CachePath();
+		std::vector<char> data;
+		if (Platform::FileExists(cachePath) && Platform::ReadFile(data, cachePath))
+		{
+			thumbnail = VideoBuffer::FromPNG(data);
+			if (thumbnail)
+			{
+				Platform::TouchFile(cachePath);
+				size = thumbnail->Size();
+				return true;
+			}
+		}
+	}
 	RendererSettings rendererSettings;
 	rendererSettings.decorationLevel = decorationLevel;
 	thumbnail = SaveRenderer::Ref().Render(save.get(), fire, rendererSettings);
@@ -36,6 +139,14 @@ bool ThumbnailRendererTask::doWork()
 	{
 		thumbnail->ResizeToFit(size, true);
 		size = thumbnail->Size();
+		if (cachePath.size())
+		{
+			// only ever read back by this cache, so size matters less than not holding up the renderer
+			if (auto data = thumbnail->ToPNG(format::pngPresetFast))
+			{
+				WriteCacheEntry(*data, cachePath);
+			}
+		}
 		return true;
 	}
 	else
@@ -1,8 +1,11 @@
 #pragma once
+#include "common/String.h"
 #include "common/Vec2.h"
 #include "tasks/AbandonableTask.h"
 #include "graphics/RendererSettings.h"
 
+#include <atomic>
+#include <cstdint>
 #include <memory>
 
 class GameSave;
@@ -13,12 +16,16 @@ class ThumbnailRendererTask : public AbandonableTask
 	Vec2<int> size;
 	RendererSettings::DecorationLevel decorationLevel;
 	bool fire;
+	uint64_t contentHash;
 	std::unique_ptr<VideoBuffer> thumbnail;
 
-	static int queueSize;
+	ByteString CachePath() const;
+
+	static std::atomic<int> queueSize; // destructors may run on TaskPool workers
 
 public:
-	ThumbnailRendererTask(GameSave const &, Vec2<int> size, RendererSettings::DecorationLevel newDecorationLevel, bool fire);
+	// thumbnails of saves with a nonzero contentHash (see SaveFile::HashData) are cached in THUMBNAIL_DIR
+	ThumbnailRendererTask(GameSave const &, Vec2<int> size, RendererSettings::DecorationLevel newDecorationLevel, bool fire, uint64_t newContentHash = 0);
 	virtual ~ThumbnailRendererTask();
 
 	virtual bool doWork() override;
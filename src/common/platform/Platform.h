@@ -19,6 +19,10 @@ namespace Platform
 	long unsigned int GetTime();
 
 	bool Stat(ByteString filename);
+	// in seconds since the epoch, std::nullopt if the file doesn't exist
+	std::optional<int64_t> LastModified(ByteString filename);
+	// sets the modification time of an existing file to now; @return true on success
+	bool TouchFile(ByteString filename);
 	bool FileExists(ByteString filename);
 	bool DirectoryExists(ByteString directory);
 	bool IsLink(ByteString path);
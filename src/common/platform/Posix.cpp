@@ -42,6 +42,21 @@ bool Stat(ByteString filename)
 	}
 }
 
+std::optional<int64_t> LastModified(ByteString filename)
+{
+	struct stat s;
+	if (stat(filename.c_str(), &s) == 0)
+	{
+		return int64_t(s.st_mtime);
+	}
+	return std::nullopt;
+}
+
+bool TouchFile(ByteString filename)
+{
+	return utimes(filename.c_str(), nullptr) == 0;
+}
+
 bool FileExists(ByteString filename)
 {
 	struct stat s;
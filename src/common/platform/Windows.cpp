@@ -3,6 +3,7 @@
 #include "Config.h"
 #include <iostream>
 #include <sys/stat.h>
+#include <sys/utime.h>
 #include <io.h>
 #include <fcntl.h>
 #include <shlobj.h>
@@ -56,6 +57,21 @@ bool Stat(ByteString filename)
 	}
 }
 
+std::optional<int64_t> LastModified(ByteString filename)
+{
+	struct _stat s;
+	if (_wstat(WinWiden(filename).c_str(), &s) == 0)
+	{
+		return int64_t(s.st_mtime);
+	}
+	return std::nullopt;
+}
+
+bool TouchFile(ByteString filename)
+{
+	return _wutime(WinWiden(filename).c_str(), nullptr) == 0;
+}
+
 bool FileExists(ByteString filename)
 {
 	struct _stat s;
@@ -2,12 +2,14 @@
 #include "bzip2/bz2wrap.h"
 #include "font_bz2.h"
 #include <array>
+#include <atomic>
 #include <bit>
 #include <cstdint>
+#include <unordered_map>
 
-unsigned char *font_data = nullptr;
-unsigned int *font_ptrs = nullptr;
-unsigned int (*font_ranges)[2] = nullptr;
+static unsigned char *font_data = nullptr;
+static unsigned int *font_ptrs = nullptr;
+static unsigned int (*font_ranges)[2] = nullptr;
 
 FontReader::FontReader(unsigned char const *_pointer):
 	pointer(_pointer + 1),
@@ -85,14 +87,30 @@ static bool InitFontData()
 	return true;
 }
 
+static bool EnsureFontData()
+{
+	// Text may be drawn on several threads at once. Every lookup goes through this static, whose
+	// initialization is thread-safe, so no thread sees font_data set before the rest of it; after
+	// this, font data only changes through SetFontData, on the font editor's single thread.
+	static auto initialized = InitFontData();
+	return initialized;
+}
+
+void FontReader::SetFontData(unsigned char *data, unsigned int *ptrs, unsigned int (*ranges)[2])
+{
+	// make sure the built-in data is loaded now rather than later, on top of this
+	EnsureFontData();
+	font_data = data;
+	font_ptrs = ptrs;
+	font_ranges = ranges;
+	InvalidateGlyphs();
+}
+
 unsigned char const *FontReader::lookupChar(String::value_type ch)
 {
-	if (!font_data)
+	if (!EnsureFontData())
 	{
-		if (!InitFontData())
-		{
-			throw std::runtime_error("font data corrupt");
-		}
+		throw std::runtime_error("font data corrupt");
 	}
 	size_t offset = 0;
 	for(int i = 0; font_ranges[i][1]; i++)
@@ -130,3 +148,35 @@ int FontReader::NextPixel()
 	data >>= 2;
 	return old & 0x3;
 }
+
+static std::atomic<int> glyphGeneration = 0;
+
+FontGlyph const &FontReader::Glyph(String::value_type ch)
+{
+	// one cache per thread so that lookups need no locking; the generation check catches InvalidateGlyphs
+	thread_local std::unordered_map<String::value_type, FontGlyph> glyphs;
+	thread_local int generation = 0;
+	if (generation != glyphGeneration)
+	{
+		glyphs.clear();
+		generation = glyphGeneration;
+	}
+	auto it = glyphs.find(ch);
+	if (it == glyphs.end())
+	{
+		FontReader reader(ch);
+		FontGlyph glyph{ reader.GetWidth(), {} };
+		glyph.pixels.resize(glyph.width * FONT_H);
+		for (auto &px : glyph.pixels)
+		{
+			px = uint8_t(reader.NextPixel());
+		}
+		it = glyphs.emplace(ch, std::move(glyph)).first;
+	}
+	return it->second;
+}
+
+void FontReader::InvalidateGlyphs()
+{
+	glyphGeneration++;
+}
@@ -1,10 +1,20 @@
 #pragma once
 #include <cstddef>
+#include <cstdint>
+#include <vector>
 
 #include "common/String.h"
 
 constexpr auto FONT_H = 12;
 
+// A character decoded into one byte per pixel, FONT_H rows of width pixels each, with values from 0 to 3 like
+// FontReader::NextPixel returns them
+struct FontGlyph
+{
+	int width;
+	std::vector<uint8_t> pixels;
+};
+
 class FontReader
 {
 	unsigned char const *pointer;
@@ -19,4 +29,11 @@ public:
 	FontReader(String::value_type ch);
 	int GetWidth() const;
 	int NextPixel();
+
+	// Decoded glyphs are cached per thread; the reference stays valid until InvalidateGlyphs is called
+	static FontGlyph const &Glyph(String::value_type ch);
+	// Call after changing font data, e.g. in the font editor
+	static void InvalidateGlyphs();
+	// Replaces the built-in font data, for the font editor; the data must outlive its use
+	static void SetFontData(unsigned char *data, unsigned int *ptrs, unsigned int (*ranges)[2]);
 };
@@ -48,6 +48,109 @@ void VideoBuffer::Crop(Rect<int> rect)
 	video.SetSize(newVideo.Size());
 }
 
+namespace
+{
+	// The weights of one destination sample, over consecutive source samples starting at first. Contributions that the
+	// Resampler clamps to the same edge sample are merged, and gaps left by zero weights are filled with zeroes.
+	struct FixedContributions
+	{
+		int first;
+		std::vector<int16_t> weights;
+	};
+
+	constexpr int weightBits = 14;
+	constexpr int intermediateBits = 6; // fractional bits kept between the vertical and the horizontal pass
+
+	std::vector<FixedContributions> FixedPointContributions(Resampler::Contrib_List const *clist, int count)
+	{
+		std::vector<FixedContributions> contributions(count);
+		for (int i = 0; i < count; i++)
+		{
+			auto &list = clist[i];
+			auto first = int(list.p[0].pixel), last = first;
+			for (int k = 0; k < list.n; k++)
+			{
+				first = std::min(first, int(list.p[k].pixel));
+				last = std::max(last, int(list.p[k].pixel));
+			}
+			std::vector<float> weights(last - first + 1, 0.0f);
+			for (int k = 0; k < list.n; k++)
+				weights[list.p[k].pixel - first] += list.p[k].weight;
+			// like the Resampler, make the weights add up to exactly 1 by adjusting the largest one
+			auto &out = contributions[i];
+			out.first = first;
+			out.weights.resize(weights.size());
+			int total = 0;
+			size_t largest = 0;
+			for (size_t k = 0; k < weights.size(); k++)
+			{
+				out.weights[k] = int16_t(std::lround(weights[k] * (1 << weightBits)));
+				total += out.weights[k];
+				if (out.weights[k] > out.weights[largest])
+					largest = k;
+			}
+			out.weights[largest] += (1 << weightBits) - total;
+		}
+		return contributions;
+	}
+}
+
+// Does what the Resampler does with the same contributor lists, but in 16-bit fixed point and on planar rows, so
+// that both passes are plain multiply-accumulate loops over contiguous memory, which the compiler vectorizes. Only
+// used for downscaling, which is what thumbnails and previews do; the Resampler handles everything else.
+static PlaneAdapter<std::vector<pixel>> DownscaleFixedPoint(PlaneAdapter<std::vector<pixel>> const &source, Vec2<int> size, Resampler::Contrib_List const *clistX, Resampler::Contrib_List const *clistY)
+{
+	auto contributionsX = FixedPointContributions(clistX, size.X);
+	auto contributionsY = FixedPointContributions(clistY, size.Y);
+
+	auto width = source.Size().X;
+	// each source row is stored as PIXELCHANNELS consecutive planes of width samples
+	std::vector<int16_t> planes(source.Size().Y * PIXELCHANNELS * width);
+	for (int y = 0; y < source.Size().Y; y++)
+		for (int c = 0; c < PIXELCHANNELS; c++)
+			for (int x = 0; x < width; x++)
+				planes[(y * PIXELCHANNELS + c) * width + x] = uint8_t(source[{ x, y }] >> (8 * c));
+
+	PlaneAdapter<std::vector<pixel>> output(size);
+	std::vector<int32_t> sums(PIXELCHANNELS * width);
+	std::vector<int16_t> row(PIXELCHANNELS * width);
+	for (int destY = 0; destY < size.Y; destY++)
+	{
+		auto &contributionsRow = contributionsY[destY];
+		std::fill(sums.begin(), sums.end(), 0);
+		for (size_t k = 0; k < contributionsRow.weights.size(); k++)
+		{
+			int32_t weight = contributionsRow.weights[k];
+			if (!weight)
+				continue;
+			auto const *in = &planes[(contributionsRow.first + k) * PIXELCHANNELS * width];
+			for (int i = 0; i < PIXELCHANNELS * width; i++)
+				sums[i] += int32_t(in[i]) * weight;
+		}
+		// the filter's negative lobes can push this past 255 on either side, but not past what an int16_t holds
+		for (int i = 0; i < PIXELCHANNELS * width; i++)
+			row[i] = int16_t(std::clamp(sums[i] >> (weightBits - intermediateBits), -0x8000, 0x7FFF));
+
+		for (int destX = 0; destX < size.X; destX++)
+		{
+			auto &contributionsColumn = contributionsX[destX];
+			auto const *weights = contributionsColumn.weights.data();
+			auto count = int(contributionsColumn.weights.size());
+			pixel px = 0;
+			for (int c = 0; c < PIXELCHANNELS; c++)
+			{
+				auto const *in = &row[c * width + contributionsColumn.first];
+				int32_t sum = 0;
+				for (int k = 0; k < count; k++)
+					sum += int32_t(in[k]) * int32_t(weights[k]);
+				px |= pixel(std::clamp(sum >> (weightBits + intermediateBits), 0, 255)) << (8 * c);
+			}
+			output[{ destX, destY }] = px;
+		}
+	}
+	return output;
+}
+
 void VideoBuffer::Resize(Vec2<int> size, bool resample)
 {
 	if (size == Size())
@@ -70,6 +173,12 @@ void VideoBuffer::Resize(Vec2<int> size, bool resample)
 			);
 			clist_x = ptr->get_clist_x();
 			clist_y = ptr->get_clist_y();
+			if (clist_x && clist_y && size.X <= Size().X && size.Y <= Size().Y)
+			{
+				// only the contributor lists are needed for this
+				video = DownscaleFixedPoint(video, size, clist_x, clist_y);
+				return;
+			}
 		}
 
 		std::array<std::unique_ptr<float []>, PIXELCHANNELS> samples;
@@ -155,9 +264,9 @@ std::unique_ptr<VideoBuffer> VideoBuffer::FromPNG(std::span<const char> data)
 		return nullptr;
 }
 
-std::unique_ptr<std::vector<char>> VideoBuffer::ToPNG() const
+std::unique_ptr<std::vector<char>> VideoBuffer::ToPNG(format::PNGPreset preset) const
 {
-	return format::PixelsToPNG(video);
+	return format::PixelsToPNG(video, preset);
 }
 
 std::vector<char> VideoBuffer::ToPPM() const
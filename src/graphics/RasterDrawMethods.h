@@ -41,6 +41,9 @@ struct RasterDrawMethods
 	void BlendRGBAImage(pixel_rgba const *, Rect<int>);
 	void BlendRGBAImage(pixel_rgba const *, Rect<int>, size_t rowStride);
 
+	// Adds colour as fire with a separate alpha for each pixel of the rect
+	void AddFireImage(unsigned int const *fireAlpha, RGB, Rect<int>);
+
 	// Returns width of character
 	int BlendChar(Vec2<int>, String::value_type, RGBA);
 	int AddChar(Vec2<int>, String::value_type, RGBA);
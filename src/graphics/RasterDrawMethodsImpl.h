@@ -31,6 +31,28 @@ static inline void xorPixelUnchecked(RasterDrawMethods<Derived> &self, V Derived
 		px = 0x404040_rgb .Pack();
 }
 
+// Calls op with a pointer to the first pixel of each row of rect, which must already be clipped, and the index of the
+// row within rect. Bulk operations work on whole spans like this so that there are no clip checks in their inner
+// loops and the compiler is free to vectorize them.
+template<typename Derived, typename V, typename Op>
+static inline void forEachSpan(RasterDrawMethods<Derived> &self, V Derived::*video, Rect<int> rect, Op &&op)
+{
+	auto &vid = static_cast<Derived &>(self).*video;
+	for (int y = 0; y < rect.size.Y; y++)
+		op(&vid[rect.pos + Vec2(0, y)], y);
+}
+
+static inline void blendSpan(pixel *span, int count, RGBA colour)
+{
+	if (colour.Alpha == 0xFF)
+	{
+		std::fill_n(span, count, colour.NoAlpha().Pack());
+		return;
+	}
+	for (int i = 0; i < count; i++)
+		span[i] = RGB::Unpack(span[i]).Blend(colour).Pack();
+}
+
 template<typename Derived>
 inline void RasterDrawMethods<Derived>::DrawPixel(Vec2<int> pos, RGB colour)
 {
@@ -142,8 +164,11 @@ void RasterDrawMethods<Derived>::DrawFilledRect(Rect<int> rect, RGB colour)
 template<typename Derived>
 void RasterDrawMethods<Derived>::BlendFilledRect(Rect<int> rect, RGBA colour)
 {
-	for (auto pos : rect & clipRect())
-		blendPixelUnchecked(*this, &Derived::video, pos, colour);
+	rect &= clipRect();
+	if (rect && colour.Alpha)
+		forEachSpan(*this, &Derived::video, rect, [colour, width = rect.size.X](pixel *span, int) {
+			blendSpan(span, width, colour);
+		});
 }
 
 template<typename Derived>
@@ -158,8 +183,11 @@ template<typename Derived>
 void RasterDrawMethods<Derived>::BlendFilledEllipse(Vec2<int> center, Vec2<int> size, RGBA colour)
 {
 	RasterizeEllipseRows(Vec2(float(size.X * size.X), float(size.Y * size.Y)), [this, center, colour](int xLim, int dy) {
-		for (auto pos : clipRect() & RectBetween(center + Vec2(-xLim, dy), center + Vec2(xLim, dy)))
-			blendPixelUnchecked(*this, &Derived::video, pos, colour);
+		auto row = clipRect() & RectBetween(center + Vec2(-xLim, dy), center + Vec2(xLim, dy));
+		if (row)
+			forEachSpan(*this, &Derived::video, row, [colour, width = row.size.X](pixel *span, int) {
+				blendSpan(span, width, colour);
+			});
 	});
 }
 
@@ -184,13 +212,14 @@ void RasterDrawMethods<Derived>::BlendImage(pixel const *data, uint8_t alpha, Re
 				video.RowIterator(Vec2(rect.pos.X, y))
 			);
 	}
-	else
+	else if (rect)
 	{
-		for (auto pos : rect)
-		{
-			pixel const px = data[(pos.X - origin.X) + (pos.Y - origin.Y) * rowStride];
-			blendPixelUnchecked(*this, &Derived::video, pos, RGB::Unpack(px).WithAlpha(alpha));
-		}
+		auto *src = data + (rect.pos.X - origin.X) + (rect.pos.Y - origin.Y) * rowStride;
+		forEachSpan(*this, &Derived::video, rect, [src, rowStride, alpha, width = rect.size.X](pixel *span, int y) {
+			auto *srcRow = src + y * rowStride;
+			for (int i = 0; i < width; i++)
+				span[i] = RGB::Unpack(span[i]).Blend(RGB::Unpack(srcRow[i]).WithAlpha(alpha)).Pack();
+		});
 	}
 }
 
@@ -205,9 +234,19 @@ void RasterDrawMethods<Derived>::XorImage(unsigned char const *data, Rect<int> r
 {
 	auto origin = rect.pos;
 	rect &= clipRect();
-	for (auto pos : rect)
-		if (data[(pos.X - origin.X) + (pos.Y - origin.Y) * rowStride])
-			xorPixelUnchecked(*this, &Derived::video, pos);
+	if (!rect)
+		return;
+	auto *src = data + (rect.pos.X - origin.X) + (rect.pos.Y - origin.Y) * rowStride;
+	forEachSpan(*this, &Derived::video, rect, [src, rowStride, width = rect.size.X](pixel *span, int y) {
+		auto *srcRow = src + y * rowStride;
+		for (int i = 0; i < width; i++)
+		{
+			// no branch on srcRow[i] so that this vectorizes
+			auto const c = RGB::Unpack(span[i]);
+			auto const xored = (2 * c.Red + 3 * c.Green + c.Blue < 512) ? 0xC0C0C0_rgb .Pack() : 0x404040_rgb .Pack();
+			span[i] = srcRow[i] ? xored : span[i];
+		}
+	});
 }
 
 template<typename Derived>
@@ -221,32 +260,72 @@ void RasterDrawMethods<Derived>::BlendRGBAImage(pixel_rgba const *data, Rect<int
 {
 	auto origin = rect.pos;
 	rect &= clipRect();
-	for (auto pos : rect)
-	{
-		pixel const px = data[(pos.X - origin.X) + (pos.Y - origin.Y) * rowStride];
-		blendPixelUnchecked(*this, &Derived::video, pos, RGBA::Unpack(px));
-	}
+	if (!rect)
+		return;
+	auto *src = data + (rect.pos.X - origin.X) + (rect.pos.Y - origin.Y) * rowStride;
+	forEachSpan(*this, &Derived::video, rect, [src, rowStride, width = rect.size.X](pixel *span, int y) {
+		auto *srcRow = src + y * rowStride;
+		for (int i = 0; i < width; i++)
+			span[i] = RGB::Unpack(span[i]).Blend(RGBA::Unpack(srcRow[i])).Pack();
+	});
+}
+
+template<typename Derived>
+void RasterDrawMethods<Derived>::AddFireImage(unsigned int const *fireAlpha, RGB colour, Rect<int> rect)
+{
+	size_t rowStride = rect.size.X;
+	auto origin = rect.pos;
+	rect &= clipRect();
+	if (!rect)
+		return;
+	auto *src = fireAlpha + (rect.pos.X - origin.X) + (rect.pos.Y - origin.Y) * rowStride;
+	forEachSpan(*this, &Derived::video, rect, [src, rowStride, colour, width = rect.size.X](pixel *span, int y) {
+		auto *srcRow = src + y * rowStride;
+		for (int i = 0; i < width; i++)
+			span[i] = RGB::Unpack(span[i]).AddFire(colour, srcRow[i]).Pack();
+	});
+}
+
+// Calls op with each span of a glyph drawn at pos that is inside the clip rect, along with the matching pixels of
+// the glyph and alpha values for them.
+template<typename Derived, typename V, typename Op>
+static inline void forEachGlyphSpan(RasterDrawMethods<Derived> &self, V Derived::*video, Rect<int> clip, Vec2<int> pos, FontGlyph const &glyph, uint8_t alpha, Op &&op)
+{
+	auto const origin = pos + Vec2(0, -2);
+	auto const rect = RectSized(origin, Vec2(glyph.width, FONT_H)) & clip;
+	if (!rect)
+		return;
+	uint8_t const alphas[4] = { 0, uint8_t(alpha / 3), uint8_t(2 * alpha / 3), alpha };
+	auto const *src = glyph.pixels.data() + (rect.pos.X - origin.X) + (rect.pos.Y - origin.Y) * glyph.width;
+	forEachSpan(self, video, rect, [&op, &alphas, src, &glyph, width = rect.size.X](pixel *span, int y) {
+		op(span, src + y * glyph.width, alphas, width);
+	});
 }
 
 template<typename Derived>
 int RasterDrawMethods<Derived>::BlendChar(Vec2<int> pos, String::value_type ch, RGBA colour)
 {
-	FontReader reader(ch);
-	auto const rect = RectSized(Vec2(0, -2), Vec2(reader.GetWidth(), FONT_H));
-	for (auto off : rect.template Range<TOP_TO_BOTTOM, LEFT_TO_RIGHT>())
-		BlendPixel(pos + off, colour.NoAlpha().WithAlpha(reader.NextPixel() * colour.Alpha / 3));
-	return reader.GetWidth();
+	auto &glyph = FontReader::Glyph(ch);
+	RGB const c = colour.NoAlpha();
+	forEachGlyphSpan(*this, &Derived::video, clipRect(), pos, glyph, colour.Alpha, [c](pixel *span, uint8_t const *glyphRow, uint8_t const *alphas, int width) {
+		for (int i = 0; i < width; i++)
+			if (glyphRow[i])
+				span[i] = RGB::Unpack(span[i]).Blend(c.WithAlpha(alphas[glyphRow[i]])).Pack();
+	});
+	return glyph.width;
 }
 
 template<typename Derived>
 int RasterDrawMethods<Derived>::AddChar(Vec2<int> pos, String::value_type ch, RGBA colour)
 {
-	FontReader reader(ch);
+	auto &glyph = FontReader::Glyph(ch);
 	RGB const c = colour.NoAlpha();
-	auto const rect = RectSized(Vec2(0, -2), Vec2(reader.GetWidth(), FONT_H));
-	for (auto off : rect.template Range<TOP_TO_BOTTOM, LEFT_TO_RIGHT>())
-		AddPixel(pos + off, c.WithAlpha(reader.NextPixel() * colour.Alpha / 3));
-	return reader.GetWidth();
+	forEachGlyphSpan(*this, &Derived::video, clipRect(), pos, glyph, colour.Alpha, [c](pixel *span, uint8_t const *glyphRow, uint8_t const *alphas, int width) {
+		for (int i = 0; i < width; i++)
+			if (glyphRow[i])
+				span[i] = RGB::Unpack(span[i]).Add(c.WithAlpha(alphas[glyphRow[i]])).Pack();
+	});
+	return glyph.width;
 }
 
 template<typename Derived>
@@ -307,8 +386,7 @@ Vec2<int> RasterDrawMethods<Derived>::BlendText(Vec2<int> orig_pos, String const
 		{
 			int dx = BlendChar(pos, str[i], colour.WithAlpha(alpha));
 			if (underline)
-				for (int i = 0; i < dx; i++)
-					BlendPixel(pos + Vec2(i, FONT_H), colour.WithAlpha(alpha));
+				BlendFilledRect(RectSized(pos + Vec2(0, FONT_H), Vec2(dx, 1)), colour.WithAlpha(alpha));
 			pos.X += dx;
 		}
 	}
@@ -336,7 +414,7 @@ void RasterDrawMethods<Derived>::Clear()
 template<typename Derived>
 int RasterDrawMethods<Derived>::CharWidth(String::value_type ch)
 {
-	return FontReader(ch).GetWidth();
+	return FontReader::Glyph(ch).width;
 }
 
 template<typename Derived>
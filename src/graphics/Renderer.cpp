@@ -12,9 +12,32 @@
 #include "simulation/gravity/Gravity.h"
 #include "simulation/orbitalparts.h"
 #include "simulation/elements/SOAP.h"
+#include "tasks/TaskPool.h"
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 #include <numbers>
+#include <thread>
+
+namespace
+{
+	// Runs func(begin, end) on contiguous bands that cover [0, count), spread over the TaskPool. Only for work whose
+	// bands don't write to the same memory, such as filling separate rows of the frame.
+	template<class Func>
+	void ForEachBand(int count, Func func)
+	{
+		static const int maxBands = std::clamp(int(std::thread::hardware_concurrency()), 1, 8);
+		auto bands = std::min(maxBands, count);
+		if (bands <= 1)
+		{
+			func(0, count);
+			return;
+		}
+		TaskPool::Ref().Parallel(bands, [count, bands, &func](int band) {
+			func(count * band / bands, count * (band + 1) / bands);
+		}, TaskPriority::high);
+	}
+}
 
 void Renderer::RenderBackground()
 {
@@ -49,34 +72,91 @@ void Renderer::RenderSimulation()
 
 void Renderer::ApproximateAccumulation()
 {
+	if (!(renderMode & FIREMODE))
+	{
+		return;
+	}
+	// colours are worked out once and then replayed into the fire buffers, which is what rendering 15 frames
+	// would do without drawing anything or running particle graphics functions 15 times
+	std::vector<FireSource> fireSources;
+	render_parts(&fireSources);
 	for (int i = 0; i < 15; ++i)
 	{
-		render_parts();
-		render_fire();
-		Clear();
+		for (auto &source : fireSources)
+		{
+			AccumulateFire(source);
+		}
+		DecayFire();
 	}
 }
 
-void Renderer::render_gravlensing(const RendererFrame &source)
+std::pair<Renderer::GraphicsMemo *, bool> Renderer::LookUpGraphicsMemo(const Particle &part, unsigned int dependsOn)
 {
-	for (auto p : RES.OriginRect())
+	static const auto &properties = Particle::GetProperties();
+	decltype(GraphicsMemo::fields) fields;
+	auto fieldCount = 0;
+	auto hash = uint32_t(2166136261U) ^ uint32_t(part.type);
+	for (auto field = 0U; field < properties.size(); ++field)
 	{
-		auto cp = p / CELL;
-		auto rp = Vec2{ int(p.X - sim->gravOut.forceX[cp] * 0.75f  + 0.5f), int(p.Y - sim->gravOut.forceY[cp] * 0.75f  + 0.5f) };
-		auto gp = Vec2{ int(p.X - sim->gravOut.forceX[cp] * 0.875f + 0.5f), int(p.Y - sim->gravOut.forceY[cp] * 0.875f + 0.5f) };
-		auto bp = Vec2{ int(p.X - sim->gravOut.forceX[cp]          + 0.5f), int(p.Y - sim->gravOut.forceY[cp]          + 0.5f) };
-		if (RES.OriginRect().Contains(rp) &&
-		    RES.OriginRect().Contains(gp) &&
-		    RES.OriginRect().Contains(bp))
+		if (dependsOn & (1U << field))
 		{
-			auto v = RGB::Unpack(video[p]);
-			video[p] = RGB(
-				std::min(0xFF, RGB::Unpack(source[rp]).Red   + v.Red  ),
-				std::min(0xFF, RGB::Unpack(source[gp]).Green + v.Green),
-				std::min(0xFF, RGB::Unpack(source[bp]).Blue  + v.Blue )
-			).Pack();
+			uint32_t value;
+			std::memcpy(&value, reinterpret_cast<const char *>(&part) + properties[field].Offset, sizeof(value));
+			if (properties[field].Type == StructProperty::Float)
+			{
+				float floatValue;
+				std::memcpy(&floatValue, &value, sizeof(floatValue));
+				auto bucket = std::floor(floatValue / graphicsMemoFloatBucket);
+				// clamped so that the conversion is defined; NaN gets a bucket of its own
+				value = std::isnan(bucket) ? uint32_t(INT32_MAX) : uint32_t(int32_t(std::clamp(bucket, -1e9f, 1e9f)));
+			}
+			fields[fieldCount++] = value;
+			hash = (hash ^ value) * 16777619U;
 		}
 	}
+	hash ^= hash >> 15;
+	auto &memo = graphicsMemo[hash % graphicsMemo.size()];
+	if (memo.generation == graphicsMemoGeneration && memo.type == part.type && memo.fieldCount == fieldCount &&
+	    std::equal(fields.begin(), fields.begin() + fieldCount, memo.fields.begin()))
+	{
+		return { &memo, true };
+	}
+	// the caller fills in the result and the generation
+	memo.generation = 0;
+	memo.type = part.type;
+	memo.fieldCount = fieldCount;
+	std::copy(fields.begin(), fields.begin() + fieldCount, memo.fields.begin());
+	return { &memo, false };
+}
+
+void Renderer::render_gravlensing(const RendererFrame &source)
+{
+	ForEachBand(YRES, [this, &source](int begin, int end) {
+		for (auto y = begin; y < end; ++y)
+		{
+			for (auto x = 0; x < XRES; ++x)
+			{
+				auto p = Vec2{ x, y };
+				auto cp = p / CELL;
+				auto forceX = sim->gravOut.forceX[cp];
+				auto forceY = sim->gravOut.forceY[cp];
+				auto rp = Vec2{ int(p.X - forceX * 0.75f  + 0.5f), int(p.Y - forceY * 0.75f  + 0.5f) };
+				auto gp = Vec2{ int(p.X - forceX * 0.875f + 0.5f), int(p.Y - forceY * 0.875f + 0.5f) };
+				auto bp = Vec2{ int(p.X - forceX          + 0.5f), int(p.Y - forceY          + 0.5f) };
+				if (RES.OriginRect().Contains(rp) &&
+				    RES.OriginRect().Contains(gp) &&
+				    RES.OriginRect().Contains(bp))
+				{
+					auto v = RGB::Unpack(video[p]);
+					video[p] = RGB(
+						std::min(0xFF, RGB::Unpack(source[rp]).Red   + v.Red  ),
+						std::min(0xFF, RGB::Unpack(source[gp]).Green + v.Green),
+						std::min(0xFF, RGB::Unpack(source[bp]).Blue  + v.Blue )
+					).Pack();
+				}
+			}
+		}
+	});
 }
 
 std::unique_ptr<VideoBuffer> Renderer::WallIcon(int wallID, Vec2<int> size)
@@ -239,7 +319,7 @@ void Renderer::DrawSigns()
 	}
 }
 
-void Renderer::render_parts()
+void Renderer::render_parts(std::vector<FireSource> *fireSources)
 {
 	auto &sd = SimulationData::CRef();
 	auto &elements = sd.elements;
@@ -254,8 +334,17 @@ void Renderer::render_parts()
 	int orbd[4] = {0, 0, 0, 0}, orbl[4] = {0, 0, 0, 0};
 	int drawing_budget = 1000000; //Serves as an upper bound for costly effects such as SPARK, FLARE and LFLARE
 
+	if (!++graphicsMemoGeneration)
+	{
+		for (auto &memo : graphicsMemo)
+		{
+			memo.generation = 0;
+		}
+		graphicsMemoGeneration = 1;
+	}
+
 	auto &parts = sim->parts;
-	if (gridSize)//draws the grid
+	if (gridSize && !fireSources)//draws the grid
 	{
 		for (ny=0; ny<YRES; ny++)
 			for (nx=0; nx<XRES; nx++)
@@ -328,7 +417,42 @@ void Renderer::render_parts()
 				else if(!(colorMode & COLOUR_BASC))
 				{
 					auto *graphics = elements[t].Graphics;
-					auto makeReady = !graphics || graphics(gfctx, &(sim->parts[i]), nx, ny, &pixel_mode, &cola, &colr, &colg, &colb, &firea, &firer, &fireg, &fireb); //That's a lot of args, a struct might be better
+					GraphicsMemo *memo = nullptr;
+					auto memoHit = false;
+					if (graphics && elements[t].GraphicsDependsOn)
+					{
+						std::tie(memo, memoHit) = LookUpGraphicsMemo(sim->parts[i], elements[t].GraphicsDependsOn);
+					}
+					auto makeReady = false;
+					if (memoHit)
+					{
+						pixel_mode = memo->result.pixel_mode;
+						cola = memo->result.cola;
+						colr = memo->result.colr;
+						colg = memo->result.colg;
+						colb = memo->result.colb;
+						firea = memo->result.firea;
+						firer = memo->result.firer;
+						fireg = memo->result.fireg;
+						fireb = memo->result.fireb;
+					}
+					else
+					{
+						makeReady = !graphics || graphics(gfctx, &(sim->parts[i]), nx, ny, &pixel_mode, &cola, &colr, &colg, &colb, &firea, &firer, &fireg, &fireb); //That's a lot of args, a struct might be better
+					}
+					if (memo && !memoHit)
+					{
+						memo->generation = graphicsMemoGeneration;
+						memo->result.pixel_mode = pixel_mode;
+						memo->result.cola = cola;
+						memo->result.colr = colr;
+						memo->result.colg = colg;
+						memo->result.colb = colb;
+						memo->result.firea = firea;
+						memo->result.firer = firer;
+						memo->result.fireg = fireg;
+						memo->result.fireb = fireb;
+					}
 					if (makeReady && sim->useLuaCallbacks)
 					{
 						// useLuaCallbacks is true so we locked sd.elementGraphicsMx exclusively
@@ -506,6 +630,15 @@ void Renderer::render_parts()
 					}
 				}
 
+				if (fireSources)
+				{
+					if (firea && (pixel_mode & (FIRE_BLEND | FIRE_ADD | FIRE_SPARK)))
+					{
+						fireSources->push_back({ nx / CELL, ny / CELL, pixel_mode, firea, firer, fireg, fireb });
+					}
+					continue;
+				}
+
 				//Pixel rendering
 				if (pixel_mode & EFFECT_LINES)
 				{
@@ -830,44 +963,44 @@ void Renderer::render_parts()
 						}
 					}
 				}
-				//Fire effects
-				if(firea && (pixel_mode & FIRE_BLEND))
-				{
-					firea /= 2;
-					fire_r[ny/CELL][nx/CELL] = (firea*firer + (255-firea)*fire_r[ny/CELL][nx/CELL]) >> 8;
-					fire_g[ny/CELL][nx/CELL] = (firea*fireg + (255-firea)*fire_g[ny/CELL][nx/CELL]) >> 8;
-					fire_b[ny/CELL][nx/CELL] = (firea*fireb + (255-firea)*fire_b[ny/CELL][nx/CELL]) >> 8;
-				}
-				if(firea && (pixel_mode & FIRE_ADD))
-				{
-					firea /= 8;
-					firer = ((firea*firer) >> 8) + fire_r[ny/CELL][nx/CELL];
-					fireg = ((firea*fireg) >> 8) + fire_g[ny/CELL][nx/CELL];
-					fireb = ((firea*fireb) >> 8) + fire_b[ny/CELL][nx/CELL];
-
-					if(firer>255)
-						firer = 255;
-					if(fireg>255)
-						fireg = 255;
-					if(fireb>255)
-						fireb = 255;
-
-					fire_r[ny/CELL][nx/CELL] = firer;
-					fire_g[ny/CELL][nx/CELL] = fireg;
-					fire_b[ny/CELL][nx/CELL] = fireb;
-				}
-				if(firea && (pixel_mode & FIRE_SPARK))
-				{
-					firea /= 4;
-					fire_r[ny/CELL][nx/CELL] = (firea*firer + (255-firea)*fire_r[ny/CELL][nx/CELL]) >> 8;
-					fire_g[ny/CELL][nx/CELL] = (firea*fireg + (255-firea)*fire_g[ny/CELL][nx/CELL]) >> 8;
-					fire_b[ny/CELL][nx/CELL] = (firea*fireb + (255-firea)*fire_b[ny/CELL][nx/CELL]) >> 8;
-				}
+				AccumulateFire({ nx / CELL, ny / CELL, pixel_mode, firea, firer, fireg, fireb });
 			}
 		}
 	}
 }
 
+void Renderer::AccumulateFire(FireSource source)
+{
+	auto &r = fire_r[source.cellY][source.cellX];
+	auto &g = fire_g[source.cellY][source.cellX];
+	auto &b = fire_b[source.cellY][source.cellX];
+	auto firea = source.a;
+	if(firea && (source.pixelMode & FIRE_BLEND))
+	{
+		firea /= 2;
+		r = (firea*source.r + (255-firea)*r) >> 8;
+		g = (firea*source.g + (255-firea)*g) >> 8;
+		b = (firea*source.b + (255-firea)*b) >> 8;
+	}
+	if(firea && (source.pixelMode & FIRE_ADD))
+	{
+		firea /= 8;
+		source.r = std::min(((firea*source.r) >> 8) + r, 255);
+		source.g = std::min(((firea*source.g) >> 8) + g, 255);
+		source.b = std::min(((firea*source.b) >> 8) + b, 255);
+		r = source.r;
+		g = source.g;
+		b = source.b;
+	}
+	if(firea && (source.pixelMode & FIRE_SPARK))
+	{
+		firea /= 4;
+		r = (firea*source.r + (255-firea)*r) >> 8;
+		g = (firea*source.g + (255-firea)*g) >> 8;
+		b = (firea*source.b + (255-firea)*b) >> 8;
+	}
+}
+
 void Renderer::draw_other() // EMP effect
 {
 	int i, j;
@@ -953,82 +1086,186 @@ void Renderer::draw_air()
 		return;
 	if(!(displayMode & DISPLAY_AIR))
 		return;
-	int x, y, i, j;
 	auto *pv = sim->pv;
 	auto *hv = sim->hv;
 	auto *vx = sim->vx;
 	auto *vy = sim->vy;
-	auto c = 0x000000_rgb;
-	for (y=0; y<YCELLS; y++)
-		for (x=0; x<XCELLS; x++)
+	auto cellColour = [this, pv, hv, vx, vy](int x, int y) {
+		auto c = 0x000000_rgb;
+		if (displayMode & DISPLAY_AIRP)
+		{
+			c = PressureToColour(pv[y][x]);
+		}
+		else if (displayMode & DISPLAY_AIRV)
+		{
+			c = RGB(clamp_flt(fabsf(vx[y][x]), 0.0f, 8.0f),//vx adds red
+				clamp_flt(pv[y][x], 0.0f, 8.0f),//pressure adds green
+				clamp_flt(fabsf(vy[y][x]), 0.0f, 8.0f));//vy adds blue
+		}
+		else if (displayMode & DISPLAY_AIRH)
 		{
-			if (displayMode & DISPLAY_AIRP)
+			c = HeatToColour(hv[y][x], stats.hdispLimitMin, stats.hdispLimitMax);
+			//c = RGB(clamp_flt(fabsf(vx[y][x]), 0.0f, 8.0f),//vx adds red
+			//	clamp_flt(hv[y][x], 0.0f, 1600.0f),//heat adds green
+			//	clamp_flt(fabsf(vy[y][x]), 0.0f, 8.0f)).Pack();//vy adds blue
+		}
+		else if (displayMode & DISPLAY_AIRC)
+		{
+			int r;
+			int g;
+			int b;
+			// velocity adds grey
+			r = clamp_flt(fabsf(vx[y][x]), 0.0f, 24.0f) + clamp_flt(fabsf(vy[y][x]), 0.0f, 20.0f);
+			g = clamp_flt(fabsf(vx[y][x]), 0.0f, 20.0f) + clamp_flt(fabsf(vy[y][x]), 0.0f, 24.0f);
+			b = clamp_flt(fabsf(vx[y][x]), 0.0f, 24.0f) + clamp_flt(fabsf(vy[y][x]), 0.0f, 20.0f);
+			if (pv[y][x] > 0.0f)
 			{
-				c = PressureToColour(pv[y][x]);
+				r += clamp_flt(pv[y][x], 0.0f, 16.0f);//pressure adds red!
+				if (r>255)
+					r=255;
+				if (g>255)
+					g=255;
+				if (b>255)
+					b=255;
+				c = RGB(r, g, b);
 			}
-			else if (displayMode & DISPLAY_AIRV)
+			else
 			{
-				c = RGB(clamp_flt(fabsf(vx[y][x]), 0.0f, 8.0f),//vx adds red
-					clamp_flt(pv[y][x], 0.0f, 8.0f),//pressure adds green
-					clamp_flt(fabsf(vy[y][x]), 0.0f, 8.0f));//vy adds blue
+				b += clamp_flt(-pv[y][x], 0.0f, 16.0f);//pressure adds blue!
+				if (r>255)
+					r=255;
+				if (g>255)
+					g=255;
+				if (b>255)
+					b=255;
+				c = RGB(r, g, b);
 			}
-			else if (displayMode & DISPLAY_AIRH)
+		}
+		else if (displayMode & DISPLAY_AIRW)
+		{
+			auto w = 4*Air::vorticity(*sim, y, x);
+			if (w > 0.0f)
+				c = RGB(clamp_flt(w, 0.0f, 8.0f), 0, 0); //positive vorticity is red
+			else
+				c = RGB(0, 0, clamp_flt(-w, 0.0f, 8.0f)); //negative vorticity is blue
+		}
+		if (findingElement)
+		{
+			c.Red   /= 10;
+			c.Green /= 10;
+			c.Blue  /= 10;
+		}
+		return c.Pack();
+	};
+	// each band works out the colours of its rows of cells once and then fills the CELL rows of pixels they cover
+	ForEachBand(YCELLS, [this, &cellColour](int begin, int end) {
+		std::array<pixel, XRES> row;
+		for (auto y = begin; y < end; ++y)
+		{
+			for (auto x = 0; x < XCELLS; ++x)
 			{
-				c = HeatToColour(hv[y][x], stats.hdispLimitMin, stats.hdispLimitMax);
-				//c = RGB(clamp_flt(fabsf(vx[y][x]), 0.0f, 8.0f),//vx adds red
-				//	clamp_flt(hv[y][x], 0.0f, 1600.0f),//heat adds green
-				//	clamp_flt(fabsf(vy[y][x]), 0.0f, 8.0f)).Pack();//vy adds blue
+				std::fill_n(&row[x * CELL], CELL, cellColour(x, y));
 			}
-			else if (displayMode & DISPLAY_AIRC)
+			for (auto j = 0; j < CELL; ++j)
 			{
-				int r;
-				int g;
-				int b;
-				// velocity adds grey
-				r = clamp_flt(fabsf(vx[y][x]), 0.0f, 24.0f) + clamp_flt(fabsf(vy[y][x]), 0.0f, 20.0f);
-				g = clamp_flt(fabsf(vx[y][x]), 0.0f, 20.0f) + clamp_flt(fabsf(vy[y][x]), 0.0f, 24.0f);
-				b = clamp_flt(fabsf(vx[y][x]), 0.0f, 24.0f) + clamp_flt(fabsf(vy[y][x]), 0.0f, 20.0f);
-				if (pv[y][x] > 0.0f)
-				{
-					r += clamp_flt(pv[y][x], 0.0f, 16.0f);//pressure adds red!
-					if (r>255)
-						r=255;
-					if (g>255)
-						g=255;
-					if (b>255)
-						b=255;
-					c = RGB(r, g, b);
-				}
-				else
+				std::copy(row.begin(), row.end(), video.RowIterator({ 0, y * CELL + j }));
+			}
+		}
+	});
+}
+
+uint16_t Renderer::WallLayerKey(unsigned char wt, unsigned char powered) const
+{
+	// only these walls look different when powered, so keep other walls cached while emap changes under them
+	auto usesPowered = wt == WL_EWALL || wt == WL_STASIS || wt == WL_EHOLE;
+	return uint16_t(wt | ((usesPowered && powered) ? 0x100 : 0) | (findingElement ? 0x200 : 0));
+}
+
+void Renderer::RasterizeWall(std::array<pixel, CELL * CELL> &tile, unsigned char wt, unsigned char powered, pixel pc, pixel gc, int x, int y)
+{
+	auto &wtypes = SimulationData::CRef().wtypes;
+	// pixels that are drawn get an alpha byte so that DrawWalls can tell them apart from ones that are left alone
+	auto put = [&tile](int i, int j, pixel px) {
+		tile[j * CELL + i] = px | 0xFF000000;
+	};
+	tile.fill(0);
+	switch (wtypes[wt].drawstyle)
+	{
+	case 0:
+		if (wt == WL_EWALL || wt == WL_STASIS)
+		{
+			bool reverse = wt == WL_STASIS;
+			if ((powered > 0) ^ reverse)
+			{
+				for (int j = 0; j < CELL; j++)
+					for (int i =0; i < CELL; i++)
+						if (i&j&1)
+							put(i, j, pc);
+			}
+			else
+			{
+				for (int j = 0; j < CELL; j++)
+					for (int i = 0; i < CELL; i++)
+						if (!(i&j&1))
+							put(i, j, pc);
+			}
+		}
+		else if (wt == WL_WALLELEC)
+		{
+			for (int j = 0; j < CELL; j++)
+				for (int i = 0; i < CELL; i++)
 				{
-					b += clamp_flt(-pv[y][x], 0.0f, 16.0f);//pressure adds blue!
-					if (r>255)
-						r=255;
-					if (g>255)
-						g=255;
-					if (b>255)
-						b=255;
-					c = RGB(r, g, b);
+					if (!((y*CELL+j)%2) && !((x*CELL+i)%2))
+						put(i, j, pc);
+					else
+						put(i, j, 0x808080_rgb .Pack());
 				}
-			}
-			else if (displayMode & DISPLAY_AIRW)
+		}
+		else if (wt == WL_EHOLE)
+		{
+			if (powered)
 			{
-				auto w = 4*Air::vorticity(*sim, y, x);
-				if (w > 0.0f)
-					c = RGB(clamp_flt(w, 0.0f, 8.0f), 0, 0); //positive vorticity is red
-				else
-					c = RGB(0, 0, clamp_flt(-w, 0.0f, 8.0f)); //negative vorticity is blue
+				for (int j = 0; j < CELL; j++)
+					for (int i = 0; i < CELL; i++)
+						put(i, j, 0x242424_rgb .Pack());
+				for (int j = 0; j < CELL; j += 2)
+					for (int i = 0; i < CELL; i += 2)
+						put(i, j, 0x000000_rgb .Pack());
 			}
-			if (findingElement)
+			else
 			{
-				c.Red   /= 10;
-				c.Green /= 10;
-				c.Blue  /= 10;
+				for (int j = 0; j < CELL; j += 2)
+					for (int i =0; i < CELL; i += 2)
+						put(i, j, 0x242424_rgb .Pack());
 			}
-			for (j=0; j<CELL; j++)//draws the colors
-				for (i=0; i<CELL; i++)
-					video[{ x * CELL + i, y * CELL + j }] = c.Pack();
 		}
+		break;
+	case 1:
+		for (int j = 0; j < CELL; j += 2)
+			for (int i = (j>>1)&1; i < CELL; i += 2)
+				put(i, j, pc);
+		break;
+	case 2:
+		for (int j = 0; j < CELL; j += 2)
+			for (int i = 0; i < CELL; i += 2)
+				put(i, j, pc);
+		break;
+	case 3:
+		for (int j = 0; j < CELL; j++)
+			for (int i = 0; i < CELL; i++)
+				put(i, j, pc);
+		break;
+	case 4:
+		for (int j = 0; j < CELL; j++)
+			for (int i = 0; i < CELL; i++)
+				if (i == j)
+					put(i, j, pc);
+				else if (i == j+1 || (i == 0 && j == CELL-1))
+					put(i, j, gc);
+				else
+					put(i, j, 0x202020_rgb .Pack());
+		break;
+	}
 }
 
 void Renderer::DrawWalls()
@@ -1059,125 +1296,73 @@ void Renderer::DrawWalls()
 				pixel pc = prgb.Pack();
 				pixel gc = grgb.Pack();
 
-				switch (wtypes[wt].drawstyle)
+				if (wt == WL_STREAM)
 				{
-				case 0:
-					if (wt == WL_EWALL || wt == WL_STASIS)
+					float xf = x*CELL + CELL*0.5f;
+					float yf = y*CELL + CELL*0.5f;
+					int oldX = (int)(xf+0.5f), oldY = (int)(yf+0.5f);
+					int newX, newY;
+					float xVel = sim->vx[y][x]*0.125f, yVel = sim->vy[y][x]*0.125f;
+					// there is no velocity here, draw a streamline and continue
+					if (!xVel && !yVel)
 					{
-						bool reverse = wt == WL_STASIS;
-						if ((powered > 0) ^ reverse)
-						{
-							for (int j = 0; j < CELL; j++)
-								for (int i =0; i < CELL; i++)
-									if (i&j&1)
-										video[{ x * CELL + i, y * CELL + j }] = pc;
-						}
-						else
-						{
-							for (int j = 0; j < CELL; j++)
-								for (int i = 0; i < CELL; i++)
-									if (!(i&j&1))
-										video[{ x * CELL + i, y * CELL + j }] = pc;
-						}
-					}
-					else if (wt == WL_WALLELEC)
-					{
-						for (int j = 0; j < CELL; j++)
-							for (int i = 0; i < CELL; i++)
-							{
-								if (!((y*CELL+j)%2) && !((x*CELL+i)%2))
-									video[{ x * CELL + i, y * CELL + j }] = pc;
-								else
-									video[{ x * CELL + i, y * CELL + j }] = 0x808080_rgb .Pack();
-							}
+						BlendText({ x*CELL, y*CELL-2 }, 0xE00D, 0xFFFFFF_rgb .WithAlpha(128));
+						AddPixel({ oldX, oldY }, 0xFFFFFF_rgb .WithAlpha(255));
+						continue;
 					}
-					else if (wt == WL_EHOLE)
+					bool changed = false;
+					for (int t = 0; t < 1024; t++)
 					{
-						if (powered)
+						newX = (int)(xf+0.5f);
+						newY = (int)(yf+0.5f);
+						if (newX != oldX || newY != oldY)
 						{
-							for (int j = 0; j < CELL; j++)
-								for (int i = 0; i < CELL; i++)
-									video[{ x * CELL + i, y * CELL + j }] = 0x242424_rgb .Pack();
-							for (int j = 0; j < CELL; j += 2)
-								for (int i = 0; i < CELL; i += 2)
-									video[{ x * CELL + i, y * CELL + j }] = 0x000000_rgb .Pack();
+							changed = true;
+							oldX = newX;
+							oldY = newY;
 						}
-						else
+						if (changed && (newX<0 || newX>=XRES || newY<0 || newY>=YRES))
+							break;
+						AddPixel({ newX, newY }, 0xFFFFFF_rgb .WithAlpha(64));
+						// cache velocity and other checks so we aren't running them constantly
+						if (changed)
 						{
-							for (int j = 0; j < CELL; j += 2)
-								for (int i =0; i < CELL; i += 2)
-									video[{ x * CELL + i, y * CELL + j }] = 0x242424_rgb .Pack();
+							int wallX = newX/CELL;
+							int wallY = newY/CELL;
+							xVel = sim->vx[wallY][wallX]*0.125f;
+							yVel = sim->vy[wallY][wallX]*0.125f;
+							if (wallX != x && wallY != y && sim->bmap[wallY][wallX] == WL_STREAM)
+								break;
 						}
+						xf += xVel;
+						yf += yVel;
 					}
-					else if (wt == WL_STREAM)
+					BlendText({ x*CELL, y*CELL-2 }, 0xE00D, 0xFFFFFF_rgb .WithAlpha(128));
+				}
+				else
+				{
+					// walls other than streams only depend on their type, whether they are powered and findingElement,
+					// so they are rasterized into wallLayer once and only redrawn from there until one of these changes
+					auto cell = y * XCELLS + x;
+					auto key = WallLayerKey(wt, powered);
+					auto &tile = wallLayer[cell];
+					if (wallLayerKeys[cell] != key)
 					{
-						float xf = x*CELL + CELL*0.5f;
-						float yf = y*CELL + CELL*0.5f;
-						int oldX = (int)(xf+0.5f), oldY = (int)(yf+0.5f);
-						int newX, newY;
-						float xVel = sim->vx[y][x]*0.125f, yVel = sim->vy[y][x]*0.125f;
-						// there is no velocity here, draw a streamline and continue
-						if (!xVel && !yVel)
-						{
-							BlendText({ x*CELL, y*CELL-2 }, 0xE00D, 0xFFFFFF_rgb .WithAlpha(128));
-							AddPixel({ oldX, oldY }, 0xFFFFFF_rgb .WithAlpha(255));
-							continue;
-						}
-						bool changed = false;
-						for (int t = 0; t < 1024; t++)
+						RasterizeWall(tile, wt, powered, pc, gc, x, y);
+						wallLayerKeys[cell] = key;
+					}
+					for (int j = 0; j < CELL; j++)
+					{
+						auto *row = &video[{ x * CELL, y * CELL + j }];
+						for (int i = 0; i < CELL; i++)
 						{
-							newX = (int)(xf+0.5f);
-							newY = (int)(yf+0.5f);
-							if (newX != oldX || newY != oldY)
+							auto px = tile[j * CELL + i];
+							if (px)
 							{
-								changed = true;
-								oldX = newX;
-								oldY = newY;
+								row[i] = px & 0xFFFFFF;
 							}
-							if (changed && (newX<0 || newX>=XRES || newY<0 || newY>=YRES))
-								break;
-							AddPixel({ newX, newY }, 0xFFFFFF_rgb .WithAlpha(64));
-							// cache velocity and other checks so we aren't running them constantly
-							if (changed)
-							{
-								int wallX = newX/CELL;
-								int wallY = newY/CELL;
-								xVel = sim->vx[wallY][wallX]*0.125f;
-								yVel = sim->vy[wallY][wallX]*0.125f;
-								if (wallX != x && wallY != y && sim->bmap[wallY][wallX] == WL_STREAM)
-									break;
-							}
-							xf += xVel;
-							yf += yVel;
 						}
-						BlendText({ x*CELL, y*CELL-2 }, 0xE00D, 0xFFFFFF_rgb .WithAlpha(128));
 					}
-					break;
-				case 1:
-					for (int j = 0; j < CELL; j += 2)
-						for (int i = (j>>1)&1; i < CELL; i += 2)
-							video[{ x * CELL + i, y * CELL + j }] = pc;
-					break;
-				case 2:
-					for (int j = 0; j < CELL; j += 2)
-						for (int i = 0; i < CELL; i += 2)
-							video[{ x * CELL + i, y * CELL + j }] = pc;
-					break;
-				case 3:
-					for (int j = 0; j < CELL; j++)
-						for (int i = 0; i < CELL; i++)
-							video[{ x * CELL + i, y * CELL + j }] = pc;
-					break;
-				case 4:
-					for (int j = 0; j < CELL; j++)
-						for (int i = 0; i < CELL; i++)
-							if (i == j)
-								video[{ x * CELL + i, y * CELL + j }] = pc;
-							else if (i == j+1 || (i == 0 && j == CELL-1))
-								video[{ x * CELL + i, y * CELL + j }] = gc;
-							else
-								video[{ x * CELL + i, y * CELL + j }] = 0x202020_rgb .Pack();
-					break;
 				}
 
 				// when in blob view, draw some blobs...
@@ -1290,7 +1475,7 @@ void Renderer::render_fire()
 {
 	if(!(renderMode & FIREMODE))
 		return;
-	int i,j,x,y,r,g,b,a;
+	int i,j,r,g,b;
 	for (j=0; j<YCELLS; j++)
 		for (i=0; i<XCELLS; i++)
 		{
@@ -1298,17 +1483,22 @@ void Renderer::render_fire()
 			g = fire_g[j][i];
 			b = fire_b[j][i];
 			if (r || g || b)
-				for (y=-CELL; y<2*CELL; y++)
-					for (x=-CELL; x<2*CELL; x++)
-					{
-						a = fire_alpha[y+CELL][x+CELL];
-						if (findingElement)
-							a /= 2;
-						AddFirePixel({ i*CELL+x, j*CELL+y }, RGB(r, g, b), a);
-					}
-			r *= 8;
-			g *= 8;
-			b *= 8;
+				AddFireImage(findingElement ? &fire_alpha_dim[0][0] : &fire_alpha[0][0], RGB(r, g, b), RectSized(Vec2{ (i-1)*CELL, (j-1)*CELL }, Vec2{ CELL*3, CELL*3 }));
+		}
+	DecayFire();
+}
+
+// blurs the fire buffers and fades them a bit; cells are updated in place, so each one sees the already updated
+// values of the cells before it
+void Renderer::DecayFire()
+{
+	int i,j,x,y,r,g,b;
+	for (j=0; j<YCELLS; j++)
+		for (i=0; i<XCELLS; i++)
+		{
+			r = fire_r[j][i]*8;
+			g = fire_g[j][i]*8;
+			b = fire_b[j][i]*8;
 			for (y=-1; y<2; y++)
 				for (x=-1; x<2; x++)
 					if ((x || y) && i+x>=0 && j+y>=0 && i+x<XCELLS && j+y<YCELLS)
@@ -1328,11 +1518,7 @@ void Renderer::render_fire()
 
 RGB HeatToColour(float temp, float hdispLimitMin, float hdispLimitMax)
 {
-	RGB color = Renderer::heatTableAt(int((temp - hdispLimitMin) / (hdispLimitMax - hdispLimitMin) * 1024));
-	color.Red   = uint8_t(color.Red   * 0.7f);
-	color.Green = uint8_t(color.Green * 0.7f);
-	color.Blue  = uint8_t(color.Blue  * 0.7f);
-	return color;
+	return Renderer::heatDisplayTableAt(int((temp - hdispLimitMin) / (hdispLimitMax - hdispLimitMin) * 1024));
 }
 
 const std::vector<RenderPreset> Renderer::renderModePresets = {
@@ -1523,7 +1709,10 @@ void Renderer::prepare_alpha(int size, float intensity)
 					temp[y+CELL+j][x+CELL+i] += expf(-0.1f*(i*i+j*j));
 	for (x=0; x<CELL*3; x++)
 		for (y=0; y<CELL*3; y++)
+		{
 			fire_alpha[y][x] = (int)(multiplier*temp[y][x]/(CELL*CELL));
+			fire_alpha_dim[y][x] = fire_alpha[y][x] / 2;
+		}
 
 }
 
@@ -1532,6 +1721,7 @@ std::vector<RGB> Renderer::plasmaTable;
 std::vector<RGB> Renderer::heatTable;
 std::vector<RGB> Renderer::clfmTable;
 std::vector<RGB> Renderer::firwTable;
+std::vector<RGB> Renderer::heatDisplayTable;
 static bool tablesPopulated = false;
 static std::mutex tablesPopulatedMx;
 void Renderer::PopulateTables()
@@ -1583,6 +1773,14 @@ void Renderer::PopulateTables()
 			{ 0xFFFF00_rgb, 0.80f },
 			{ 0xFF0000_rgb, 1.00f },
 		}, 200);
+		// heatTable dimmed for the air heat display, so HeatToColour is a single lookup
+		heatDisplayTable = heatTable;
+		for (auto &color : heatDisplayTable)
+		{
+			color.Red   = uint8_t(color.Red   * 0.7f);
+			color.Green = uint8_t(color.Green * 0.7f);
+			color.Blue  = uint8_t(color.Blue  * 0.7f);
+		}
 	}
 }
 
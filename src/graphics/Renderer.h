@@ -5,10 +5,13 @@
 #include "RendererSettings.h"
 #include "common/tpt-rand.h"
 #include "RendererFrame.h"
+#include "gcache_item.h"
+#include <array>
 #include <cstdint>
 #include <optional>
 #include <memory>
 #include <mutex>
+#include <utility>
 #include <vector>
 
 struct RenderPreset;
@@ -47,14 +50,46 @@ class Renderer : private RendererSettings, public RasterDrawMethods<Renderer>
 	unsigned char fire_g[YCELLS][XCELLS];
 	unsigned char fire_b[YCELLS][XCELLS];
 	unsigned int fire_alpha[CELL*3][CELL*3];
+	unsigned int fire_alpha_dim[CELL*3][CELL*3]; // fire_alpha halved, used while findingElement is set
+	std::array<std::array<pixel, CELL * CELL>, NCELL> wallLayer;
+	std::array<uint16_t, NCELL> wallLayerKeys{}; // what each cell of wallLayer was rasterized for, 0 if nothing
+
+	// results of Graphics functions that declare GraphicsDependsOn, keyed by type and the values of those fields,
+	// float ones in buckets of graphicsMemoFloatBucket; entries from previous calls to render_parts have an old
+	// generation and are ignored
+	static constexpr float graphicsMemoFloatBucket = 1.f;
+	struct GraphicsMemo
+	{
+		uint32_t generation = 0;
+		int type = 0;
+		int fieldCount = 0;
+		std::array<uint32_t, 16> fields;
+		gcache_item result;
+	};
+	std::array<GraphicsMemo, 512> graphicsMemo;
+	uint32_t graphicsMemoGeneration = 0;
+
+	struct FireSource
+	{
+		int cellX, cellY;
+		int pixelMode;
+		int a, r, g, b;
+	};
 
 	void DrawBlob(Vec2<int> pos, RGB colour);
+	// returns the entry for part's graphics, and whether it already holds them
+	std::pair<GraphicsMemo *, bool> LookUpGraphicsMemo(const Particle &part, unsigned int dependsOn);
+	uint16_t WallLayerKey(unsigned char wt, unsigned char powered) const;
+	void RasterizeWall(std::array<pixel, CELL * CELL> &tile, unsigned char wt, unsigned char powered, pixel pc, pixel gc, int x, int y);
 	void DrawWalls();
 	void DrawSigns();
 	void render_gravlensing(const RendererFrame &source);
 	void render_fire();
+	void AccumulateFire(FireSource source);
+	void DecayFire();
 	void prepare_alpha(int size, float intensity);
-	void render_parts();
+	// with fireSources, only collects the fire effects of particles instead of drawing them
+	void render_parts(std::vector<FireSource> *fireSources = nullptr);
 	void draw_grav_zones();
 	void draw_air();
 	void draw_grav();
@@ -100,6 +135,7 @@ public:
 	RENDERER_TABLE(heatTable)
 	RENDERER_TABLE(clfmTable)
 	RENDERER_TABLE(firwTable)
+	RENDERER_TABLE(heatDisplayTable)
 #undef RENDERER_TABLE
 	static void PopulateTables();
 };
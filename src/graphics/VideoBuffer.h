@@ -5,6 +5,7 @@
 #include <vector>
 #include "common/Plane.h"
 #include "common/String.h"
+#include "Format.h"
 #include "gui/interface/Point.h"
 #include "Icons.h"
 #include "Pixel.h"
@@ -55,6 +56,6 @@ public:
 	void ResizeToFit(Vec2<int> bound, bool resample = false);
 
 	static std::unique_ptr<VideoBuffer> FromPNG(std::span<const char> data);
-	std::unique_ptr<std::vector<char>> ToPNG() const;
+	std::unique_ptr<std::vector<char>> ToPNG(format::PNGPreset preset = format::pngPresetDefault) const;
 	std::vector<char> ToPPM() const;
 };
@@ -17,4 +17,5 @@ public:
 	virtual ~ConfirmPrompt() = default;
 
 	void OnDraw() override;
+	bool CanSkipDraw() const override { return true; } // nothing in here changes by itself
 };
@@ -15,4 +15,5 @@ public:
 	virtual ~InformationMessage() = default;
 
 	void OnDraw() override;
+	bool CanSkipDraw() const override { return true; } // nothing in here changes by itself
 };
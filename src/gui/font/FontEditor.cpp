@@ -15,10 +15,6 @@
 #include <cstdint>
 #include <SDL.h>
 
-extern unsigned char *font_data;
-extern unsigned int *font_ptrs;
-extern unsigned int (*font_ranges)[2];
-
 void FontEditor::ReadDataFile(ByteString dataFile)
 {
 	std::fstream file;
@@ -259,9 +255,7 @@ FontEditor::FontEditor(ByteString _dataFile):
 {
 	ReadDataFile(dataFile);
 	UnpackData(fontWidths, fontPixels, fontData, fontPtrs, fontRanges);
-	font_data = fontData.data();
-	font_ptrs = fontPtrs.data();
-	font_ranges = (unsigned int (*)[2])fontRanges.data();
+	FontReader::SetFontData(fontData.data(), fontPtrs.data(), (unsigned int (*)[2])fontRanges.data());
 	
 	int baseline = 8 + FONT_H * FONT_SCALE + 4 + FONT_H + 4 + 1;
 	int currentX = 1;
@@ -617,9 +611,7 @@ void FontEditor::GrowChar()
 void FontEditor::Render()
 {
 	PackData(fontWidths, fontPixels, fontData, fontPtrs, fontRanges);
-	font_data = fontData.data();
-	font_ptrs = fontPtrs.data();
-	font_ranges = (unsigned int (*)[2])fontRanges.data();
+	FontReader::SetFontData(fontData.data(), fontPtrs.data(), (unsigned int (*)[2])fontRanges.data());
 }
 
 void FontEditor::Save()
@@ -0,0 +1,145 @@
+#include "FrameRecorder.h"
+#include "Config.h"
+#include "Format.h"
+#include "common/platform/Platform.h"
+#include "tasks/TaskPool.h"
+#include <algorithm>
+#include <iostream>
+#include <thread>
+
+constexpr int slotCount = 16;
+
+static std::vector<char> PixelsToY4MFrame(PlaneAdapter<std::vector<pixel>> const &input)
+{
+	// BT.601, limited range, no chroma subsampling
+	static const char header[] = "FRAME\n";
+	auto area = input.Size().X * input.Size().Y;
+	std::vector<char> data(sizeof(header) - 1 + area * 3);
+	std::copy(header, header + sizeof(header) - 1, data.begin());
+	auto *y = reinterpret_cast<uint8_t *>(data.data() + sizeof(header) - 1);
+	auto *u = y + area;
+	auto *v = u + area;
+	for (int i = 0; i < area; i++)
+	{
+		auto colour = RGB::Unpack(input.data()[i]);
+		int r = colour.Red, g = colour.Green, b = colour.Blue;
+		y[i] = uint8_t((( 66 * r + 129 * g +  25 * b + 128) >> 8) +  16);
+		u[i] = uint8_t(((-38 * r -  74 * g + 112 * b + 128) >> 8) + 128);
+		v[i] = uint8_t(((112 * r -  94 * g -  18 * b + 128) >> 8) + 128);
+	}
+	return data;
+}
+
+FrameRecorder::FrameRecorder(ByteString newFolder, FileType newFileType, int fps) : folder(newFolder), fileType(newFileType)
+{
+	slots.resize(slotCount);
+	for (int i = 0; i < slotCount; i++)
+	{
+		slots[i].frame = Frame(RendererFrameSize);
+		freeSlots.push_back(i);
+	}
+	if (fileType == fileTypeY4M)
+	{
+		auto filename = ByteString::Build(folder, PATH_SEP_CHAR, "frames.y4m");
+		stream.open(filename, std::ios::binary);
+		stream << "YUV4MPEG2 W" << RendererFrameSize.X << " H" << RendererFrameSize.Y << " F" << fps << ":1 Ip A1:1 C444\n";
+		if (!stream)
+		{
+			std::cerr << "FrameRecorder: failed to open " << filename << std::endl;
+		}
+	}
+	// PNG encoding is slow enough to need more than one job, writing PPM and converting to Y4M is not
+	maxJobs = fileType == fileTypePNG ? std::clamp(int(std::thread::hardware_concurrency()) - 1, 1, 4) : 1;
+}
+
+FrameRecorder::~FrameRecorder()
+{
+	std::unique_lock lk(queueMx);
+	queueCv.wait(lk, [this]() {
+		return !jobs;
+	});
+}
+
+void FrameRecorder::Push(const RendererFrame &frame)
+{
+	int slot;
+	{
+		std::lock_guard lk(queueMx);
+		if (freeSlots.empty())
+		{
+			stats.dropped++;
+			return;
+		}
+		slot = freeSlots.back();
+		freeSlots.pop_back();
+		slots[slot].index = stats.recorded++;
+	}
+	// the slot belongs to this thread until it is queued, so the copy happens outside the lock
+	std::copy(frame.data(), frame.data() + RendererFrameSize.X * RendererFrameSize.Y, slots[slot].frame.data());
+	std::lock_guard lk(queueMx);
+	pendingSlots.push_back(slot);
+	// jobs that are already running take this slot too before they return
+	if (jobs < maxJobs)
+	{
+		jobs++;
+		TaskPool::Ref().Schedule([this]() {
+			Work();
+		}, TaskPriority::normal);
+	}
+}
+
+FrameRecorder::Stats FrameRecorder::GetStats()
+{
+	std::lock_guard lk(queueMx);
+	return stats;
+}
+
+void FrameRecorder::Work()
+{
+	while (true)
+	{
+		int slot;
+		{
+			std::lock_guard lk(queueMx);
+			if (pendingSlots.empty())
+			{
+				// the destructor may go ahead as soon as the lock is released, so nothing may touch this afterwards
+				jobs--;
+				queueCv.notify_all();
+				return;
+			}
+			slot = pendingSlots.front();
+			pendingSlots.pop_front();
+		}
+		Write(slots[slot]);
+		{
+			std::lock_guard lk(queueMx);
+			freeSlots.push_back(slot);
+		}
+	}
+}
+
+void FrameRecorder::Write(const Slot &slot)
+{
+	auto filename = ByteString::Build(folder, PATH_SEP_CHAR, "frame_", Format::Width(slot.index, 6));
+	switch (fileType)
+	{
+	case fileTypePPM:
+		Platform::WriteFile(format::PixelsToPPM(slot.frame), filename + ".ppm");
+		break;
+
+	case fileTypePNG:
+		if (auto data = format::PixelsToPNG(slot.frame, format::pngPresetFast))
+		{
+			Platform::WriteFile(*data, filename + ".png");
+		}
+		break;
+
+	case fileTypeY4M:
+		{
+			auto data = PixelsToY4MFrame(slot.frame);
+			stream.write(data.data(), data.size());
+		}
+		break;
+	}
+}
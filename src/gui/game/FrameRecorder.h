@@ -0,0 +1,70 @@
+#pragma once
+#include "common/String.h"
+#include "common/Plane.h"
+#include "graphics/Pixel.h"
+#include "graphics/RendererFrame.h"
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <vector>
+
+// * A FrameRecorder writes a sequence of frames to a folder without holding up the thread that produces them. Push
+//   copies the frame into one of a fixed number of preallocated slots and returns; jobs on the TaskPool encode the
+//   slots and write them out.
+// * If every slot is still waiting to be written when a frame comes in, that frame is dropped and counted rather than
+//   waited for, so a slow disk or encoder costs frames in the recording instead of frame rate in the game.
+// * Destroying the FrameRecorder finishes writing every frame that was accepted.
+class FrameRecorder
+{
+public:
+	enum FileType
+	{
+		fileTypePPM, // one .ppm file per frame
+		fileTypePNG, // one .png file per frame
+		fileTypeY4M, // a single uncompressed 4:4:4 YUV4MPEG2 stream
+	};
+
+	struct Stats
+	{
+		int recorded = 0; // accepted by Push, whether written out already or not
+		int dropped = 0;
+	};
+
+private:
+	using Frame = PlaneAdapter<std::vector<pixel>>;
+
+	struct Slot
+	{
+		Frame frame;
+		int index = 0;
+	};
+
+	ByteString folder;
+	FileType fileType;
+	std::vector<Slot> slots;
+
+	std::mutex queueMx;
+	std::condition_variable queueCv;
+	std::vector<int> freeSlots;
+	std::deque<int> pendingSlots;
+	Stats stats;
+
+	// jobs scheduled on the TaskPool that haven't yet found pendingSlots empty, at most maxJobs
+	int jobs = 0;
+	int maxJobs;
+
+	// only for fileTypeY4M, which is written by a single job at a time so that frames end up in order
+	std::ofstream stream;
+
+	void Work();
+	void Write(const Slot &slot);
+
+public:
+	// fps only ends up in the file for fileTypeY4M, as its nominal frame rate
+	FrameRecorder(ByteString newFolder, FileType newFileType, int fps);
+	~FrameRecorder();
+
+	void Push(const RendererFrame &frame);
+	Stats GetStats();
+};
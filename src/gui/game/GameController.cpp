@@ -182,7 +182,7 @@ bool GameController::HistoryRestore()
 	//   the last history entry is what this Ctrl+Z brings you back to, not the current state.
 	if (!beforeRestore)
 	{
-		beforeRestore = gameModel->GetSimulation()->CreateSnapshot();
+		beforeRestore = gameModel->GetSimulation()->CreateSnapshot(gameModel->HistoryNewest());
 		beforeRestore->Authors = Client::Ref().GetAuthorInfo();
 	}
 	gameModel->HistoryRestore();
@@ -198,7 +198,7 @@ void GameController::HistorySnapshot()
 	// * Calling HistorySnapshot means the user decided to use the current state and
 	//   forfeit the option to go back to whatever they Ctrl+Z'd their way back from.
 	beforeRestore.reset();
-	gameModel->HistoryPush(gameModel->GetSimulation()->CreateSnapshot());
+	gameModel->HistoryPush(gameModel->GetSimulation()->CreateSnapshot(gameModel->HistoryNewest()));
 }
 
 bool GameController::HistoryForward()
@@ -803,6 +803,8 @@ void GameController::ResetSpark()
 		{
 			if (sim->parts[i].ctype >= 0 && sim->parts[i].ctype < PT_NUM && sd.elements[sim->parts[i].ctype].Enabled)
 			{
+				// written directly rather than through part_change_type, so ForEachPartOfType must be told
+				sim->partsByTypeStale[sim->parts[i].ctype] = true;
 				sim->parts[i].type = sim->parts[i].ctype;
 				sim->parts[i].ctype = sim->parts[i].life = 0;
 			}
@@ -1608,9 +1610,9 @@ ByteString GameController::TakeScreenshot(int captureUI, int fileType)
 	return gameView->TakeScreenshot(captureUI, fileType);
 }
 
-int GameController::Record(bool record)
+int GameController::Record(bool record, int fileType)
 {
-	return gameView->Record(record);
+	return gameView->Record(record, fileType);
 }
 
 void GameController::NotifyAuthUserChanged(Client * sender)
@@ -1783,6 +1785,11 @@ bool GameController::ThreadedRenderingAllowed()
 	return gameModel->GetThreadedRendering() && !GetPaused() && !commandInterface->HaveSimGraphicsEventHandlers();
 }
 
+bool GameController::HaveTickWork()
+{
+	return debugFlags || commandInterface->HaveTickWork();
+}
+
 void GameController::SetToolIndex(ByteString identifier, std::optional<int> index)
 {
 	if (commandInterface)
@@ -186,7 +186,7 @@ public:
 	bool IsValidElement(int type);
 	String WallName(int type);
 	ByteString TakeScreenshot(int captureUI, int fileType);
-	int Record(bool record);
+	int Record(bool record, int fileType);
 
 	void ResetAir();
 	void ResetSpark();
@@ -214,6 +214,8 @@ public:
 	void BeforeSimDraw();
 	void AfterSimDraw();
 	bool ThreadedRenderingAllowed();
+	// Whether Tick has work to do even while nothing else changes, e.g. debug overlays or Lua tick handlers
+	bool HaveTickWork();
 
 	void SetToolIndex(ByteString identifier, std::optional<int> index);
 	void InitCommandInterface();
@@ -31,6 +31,7 @@
 #include "simulation/ElementClasses.h"
 #include "simulation/ElementGraphics.h"
 #include "simulation/ToolClasses.h"
+#include "tasks/TaskPool.h"
 #include "gui/game/tool/DecorationTool.h"
 #include "gui/game/tool/ElementTool.h"
 #include "gui/game/tool/GOLTool.h"
@@ -43,6 +44,7 @@
 #include <iostream>
 #include <algorithm>
 #include <optional>
+#include <chrono>
 
 HistoryEntry::~HistoryEntry()
 {
@@ -555,12 +557,20 @@ int GameModel::GetDecoSpace()
 //
 //   * After all this, the front of the deque is truncated such that there are on more than
 //     undoHistoryLimit entries left.
+//   * The SnapshotDelta in history[N-2] is built on a background thread, see HistorySettle. Until
+//     it is ready, history[N-2] holds its logical Snapshot instead, which is an equally valid state.
 
 const Snapshot *GameModel::HistoryCurrent() const
 {
 	return historyCurrent.get();
 }
 
+// * The only materialised Snapshot in history, if any; new Snapshots should share tiles with this one.
+const Snapshot *GameModel::HistoryNewest() const
+{
+	return history.empty() ? nullptr : history.back().snap.get();
+}
+
 bool GameModel::HistoryCanRestore() const
 {
 	return historyPosition > 0U;
@@ -579,7 +589,7 @@ void GameModel::HistoryRestore()
 	}
 	else
 	{
-		historyCurrent = history[historyPosition].delta->Restore(*historyCurrent);
+		history[historyPosition].delta->RestoreInPlace(*historyCurrent);
 	}
 }
 
@@ -605,31 +615,49 @@ void GameModel::HistoryForward()
 	}
 	else
 	{
-		historyCurrent = history[historyPosition - 1U].delta->Forward(*historyCurrent);
+		history[historyPosition - 1U].delta->ForwardInPlace(*historyCurrent);
 	}
 }
 
 void GameModel::HistoryPush(std::unique_ptr<Snapshot> last)
 {
-	Snapshot *rebaseOnto = nullptr;
+	HistorySettle(true);
+	std::unique_ptr<Snapshot> rebaseOnto;
 	if (historyPosition)
 	{
-		rebaseOnto = history.back().snap.get();
 		if (historyPosition < history.size())
 		{
-			historyCurrent = history[historyPosition - 1U].delta->Restore(*historyCurrent);
-			rebaseOnto = historyCurrent.get();
+			history[historyPosition - 1U].delta->RestoreInPlace(*historyCurrent);
+			rebaseOnto = std::move(historyCurrent);
+		}
+		else
+		{
+			rebaseOnto = std::move(history.back().snap);
 		}
 	}
 	while (historyPosition < history.size())
 	{
 		history.pop_back();
 	}
+	// * The entry below the new Snapshot keeps a Snapshot of its own until the SnapshotDelta
+	//   that replaces it is ready; see HistorySettle. The worker gets its own copies of both
+	//   Snapshots, which is cheap because these share their tiles with the originals.
 	if (rebaseOnto)
 	{
 		auto &prev = history.back();
-		prev.delta = SnapshotDelta::FromSnapshots(*rebaseOnto, *last);
-		prev.snap.reset();
+		auto from = std::make_shared<const Snapshot>(*rebaseOnto);
+		auto to = std::make_shared<const Snapshot>(*last);
+		prev.delta.reset();
+		prev.snap = std::move(rebaseOnto);
+		historyPendingEntry = &prev;
+		historyPendingJob = std::make_shared<HistoryDeltaJob>();
+		historyPendingJob->task = std::packaged_task<std::unique_ptr<SnapshotDelta> ()>([from, to]() {
+			return SnapshotDelta::FromSnapshots(*from, *to);
+		});
+		historyPendingDelta = historyPendingJob->task.get_future();
+		TaskPool::Ref().Schedule([job = historyPendingJob]() {
+			job->Run();
+		}, TaskPriority::high);
 	}
 	history.emplace_back();
 	history.back().snap = std::move(last);
@@ -637,11 +665,40 @@ void GameModel::HistoryPush(std::unique_ptr<Snapshot> last)
 	historyCurrent.reset();
 	while (undoHistoryLimit < history.size())
 	{
+		if (&history.front() == historyPendingEntry)
+		{
+			historyPendingEntry = nullptr;
+		}
 		history.pop_front();
 		historyPosition -= 1U;
 	}
 }
 
+// * Replaces the Snapshot in historyPendingEntry with the SnapshotDelta built for it in the
+//   background, if that is done or if wait is set. Entries holding a Snapshot are valid at any
+//   position in history, so HistoryRestore and HistoryForward need not wait for this.
+void GameModel::HistorySettle(bool wait)
+{
+	if (!historyPendingDelta.valid())
+	{
+		return;
+	}
+	if (!wait && historyPendingDelta.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+	{
+		return;
+	}
+	// the pool may be busy with other jobs, in which case this is quicker than waiting for it
+	historyPendingJob->Run();
+	historyPendingJob.reset();
+	auto delta = historyPendingDelta.get();
+	if (historyPendingEntry)
+	{
+		historyPendingEntry->delta = std::move(delta);
+		historyPendingEntry->snap.reset();
+		historyPendingEntry = nullptr;
+	}
+}
+
 unsigned int GameModel::GetUndoHistoryLimit()
 {
 	return undoHistoryLimit;
@@ -660,6 +717,7 @@ void GameModel::SetVote(int direction)
 
 void GameModel::Tick()
 {
+	HistorySettle(false);
 	if (currentSave.execVoteRequest && currentSave.execVoteRequest->CheckDone())
 	{
 		try
@@ -830,31 +888,7 @@ std::unique_ptr<SaveInfo> GameModel::TakeSave()
 void GameModel::SaveToSimParameters(const GameSave &saveData)
 {
 	SetPaused(saveData.paused | GetPaused());
-	sim->gravityMode = saveData.gravityMode;
-	sim->customGravityX = saveData.customGravityX;
-	sim->customGravityY = saveData.customGravityY;
-	sim->air->airMode = saveData.airMode;
-	sim->air->ambientAirTemp = saveData.ambientAirTemp;
-	sim->air->edgePressure = saveData.edgePressure;
-	sim->air->edgeVelocityX = saveData.edgeVelocityX;
-	sim->air->edgeVelocityY = saveData.edgeVelocityY;
-	sim->air->vorticityCoeff = saveData.vorticityCoeff;
-	sim->air->convectionMode = saveData.convectionMode;
-	sim->edgeMode = saveData.edgeMode;
-	sim->legacy_enable = saveData.legacyEnable;
-	sim->water_equal_test = saveData.waterEEnabled;
-	sim->aheat_enable = saveData.aheatEnable;
-	sim->EnableNewtonianGravity(saveData.gravityEnable);
-	sim->frameCount = saveData.frameCount;
-	if (saveData.hasRngState)
-	{
-		sim->rng.state(saveData.rngState);
-	}
-	else
-	{
-		sim->rng = RNG();
-	}
-	sim->ensureDeterminism = saveData.ensureDeterminism;
+	sim->LoadSimOptions(saveData);
 }
 
 void GameModel::SetSave(std::unique_ptr<SaveInfo> newSave, bool invertIncludePressure)
@@ -6,10 +6,12 @@
 #include "simulation/CustomGOLData.h"
 #include "simulation/SimulationSettings.h"
 #include "simulation/FrameTime.h"
+#include <atomic>
 #include <vector>
 #include <deque>
 #include <memory>
 #include <optional>
+#include <future>
 #include <functional>
 #include <array>
 
@@ -95,6 +97,25 @@ private:
 	std::deque<HistoryEntry> history;
 	std::unique_ptr<Snapshot> historyCurrent;
 	unsigned int historyPosition;
+	// Run on the TaskPool, or by HistorySettle if it needs the result before a worker has picked
+	// the job up; whichever gets to it first runs it.
+	struct HistoryDeltaJob
+	{
+		std::packaged_task<std::unique_ptr<SnapshotDelta> ()> task;
+		std::atomic<bool> started = false;
+
+		void Run()
+		{
+			if (!started.exchange(true))
+			{
+				task();
+			}
+		}
+	};
+	std::shared_ptr<HistoryDeltaJob> historyPendingJob;
+	std::future<std::unique_ptr<SnapshotDelta>> historyPendingDelta;
+	HistoryEntry *historyPendingEntry = nullptr;
+	void HistorySettle(bool wait);
 	unsigned int undoHistoryLimit;
 	bool mouseClickRequired;
 	bool includePressure;
@@ -207,6 +228,7 @@ public:
 	void BuildQuickOptionMenu(GameController * controller);
 
 	const Snapshot *HistoryCurrent() const;
+	const Snapshot *HistoryNewest() const;
 	bool HistoryCanRestore() const;
 	void HistoryRestore();
 	bool HistoryCanForward() const;
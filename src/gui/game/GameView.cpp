@@ -4,6 +4,7 @@
 #include "tool/DecorationTool.h"
 #include "tool/PropertyTool.h"
 #include "Favorite.h"
+#include "FrameRecorder.h"
 #include "Format.h"
 #include "GameController.h"
 #include "GameModel.h"
@@ -197,8 +198,6 @@ GameView::GameView():
 	doScreenshot(false),
 	screenshotIndex(1),
 	lastScreenshotTime(0),
-	recordingIndex(0),
-	recording(false),
 	recordingFolder(0),
 	currentPoint(ui::Point(0, 0)),
 	lastPoint(ui::Point(0, 0)),
@@ -1010,21 +1009,28 @@ ByteString GameView::TakeScreenshot(int captureUI, int fileType)
 	return filename;
 }
 
-int GameView::Record(bool record)
+int GameView::Record(bool record, int fileType)
 {
 	if (!record)
 	{
-		recording = false;
+		// waits for the frames that are still being written
+		recorder.reset();
 		recordingFolder = 0;
 	}
-	else if (!recording)
+	else if (!recorder)
 	{
 		time_t startTime = time(nullptr);
 		recordingFolder = startTime;
 		Platform::MakeDirectory("recordings");
-		Platform::MakeDirectory(ByteString::Build("recordings", PATH_SEP_CHAR, recordingFolder));
-		recording = true;
-		recordingIndex = 0;
+		ByteString folder = ByteString::Build("recordings", PATH_SEP_CHAR, recordingFolder);
+		Platform::MakeDirectory(folder);
+		if (fileType < FrameRecorder::fileTypePPM || fileType > FrameRecorder::fileTypeY4M)
+		{
+			fileType = FrameRecorder::fileTypePPM;
+		}
+		// one frame is recorded per draw, so the draw cap is the frame rate of the recording; without one, the rate
+		// isn't fixed, and Y4M players are told it's 60
+		recorder = std::make_unique<FrameRecorder>(folder, FrameRecorder::FileType(fileType), ui::Engine::Ref().GetEffectiveDrawCap().value_or(60));
 	}
 	return recordingFolder;
 }
@@ -1900,6 +1906,16 @@ void GameView::DoDraw()
 	}
 }
 
+bool GameView::CanSkipDraw() const
+{
+	// The simulation is rendered again on every draw, but while it's paused, it only changes in response to input,
+	// which the Engine sees anyway. Everything that fades or pulses by itself has to have finished, and log entries
+	// stay at the same alpha for a while before they start fading, so they have to be gone.
+	return c->GetPaused() && !c->HaveTickWork() && !recorder && !isMouseDown && logEntries.empty() &&
+		!toolTipPresence && !infoTipPresence && !buttonTipShow && !introText &&
+		!upVoteButton->Appearance.BackgroundPulse && !downVoteButton->Appearance.BackgroundPulse;
+}
+
 void GameView::NotifyNotificationsChanged(GameModel * sender)
 {
 	for (auto *notificationComponent : notificationComponents)
@@ -2299,13 +2315,9 @@ void GameView::OnDraw()
 		TakeScreenshot(0, 0);
 	}
 
-	if(recording)
+	if (recorder)
 	{
-		std::vector<char> data = VideoBuffer(*rendererFrame).ToPPM();
-
-		ByteString filename = ByteString::Build("recordings", PATH_SEP_CHAR, recordingFolder, PATH_SEP_CHAR, "frame_", Format::Width(recordingIndex++, 6), ".ppm");
-
-		Platform::WriteFile(data, filename);
+		recorder->Push(*rendererFrame);
 	}
 
 	if (logEntries.size())
@@ -2329,9 +2341,14 @@ void GameView::OnDraw()
 		}
 	}
 
-	if (recording)
+	if (recorder)
 	{
-		String sampleInfo = String::Build("#", screenshotIndex, " ", String(0xE00E), " REC");
+		auto recorderStats = recorder->GetStats();
+		String sampleInfo = String::Build("#", recorderStats.recorded, " ", String(0xE00E), " REC");
+		if (recorderStats.dropped)
+		{
+			sampleInfo = String::Build("#", recorderStats.recorded, " (", recorderStats.dropped, " dropped) ", String(0xE00E), " REC");
+		}
 
 		int textWidth = Graphics::TextSize(sampleInfo).X - 1;
 		g->BlendFilledRect(RectSized(Vec2{ XRES-20-textWidth, 12 }, Vec2{ textWidth+8, 15 }), 0x000000_rgb .WithAlpha(127));
@@ -43,6 +43,7 @@ class ToolButton;
 class GameController;
 class Brush;
 class GameModel;
+class FrameRecorder;
 class GameView: public ui::Window
 {
 private:
@@ -81,8 +82,7 @@ private:
 	bool doScreenshot;
 	int screenshotIndex;
 	time_t lastScreenshotTime;
-	int recordingIndex;
-	bool recording;
+	std::unique_ptr<FrameRecorder> recorder;
 	int recordingFolder;
 
 	ui::Point currentPoint, lastPoint;
@@ -202,7 +202,7 @@ public:
 	SelectMode GetSelectMode() { return selectMode; }
 	void BeginStampSelection();
 	ByteString TakeScreenshot(int captureUI, int fileType);
-	int Record(bool record);
+	int Record(bool record, int fileType);
 
 	//all of these are only here for one debug lines
 	bool GetMouseDown() { return isMouseDown; }
@@ -265,6 +265,8 @@ public:
 	void DoKeyPress(int key, int scan, bool repeat, bool shift, bool ctrl, bool alt) override;
 	void DoKeyRelease(int key, int scan, bool repeat, bool shift, bool ctrl, bool alt) override;
 
+	bool CanSkipDraw() const override;
+
 	class OptionListener;
 
 	void SkipIntroText();
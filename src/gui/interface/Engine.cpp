@@ -69,6 +69,7 @@ void Engine::ConfirmExit()
 
 void Engine::ShowWindow(Window * window)
 {
+	invalidated = true;
 	CloseWindowAndEverythingAbove(window);
 	if (state_)
 		ignoreEvents = true;
@@ -122,6 +123,7 @@ void Engine::CloseWindowAndEverythingAbove(Window *window)
 
 int Engine::CloseWindow()
 {
+	invalidated = true;
 	if(!windows.empty())
 	{
 		frozenGraphics.pop();
@@ -203,6 +205,7 @@ void Engine::SimTick()
 
 void Engine::Draw()
 {
+	invalidated = false;
 	if (!frozenGraphics.empty() && !(state_ && RectSized(state_->Position, state_->Size) == g->Size().OriginRect()))
 	{
 		auto &frozen = frozenGraphics.top();
@@ -231,20 +234,34 @@ void Engine::Draw()
 	FrameIndex %= 7200;
 }
 
+bool Engine::NeedsDraw() const
+{
+	// A window is only left alone if it says that it doesn't change by itself, and only once a frame has come out
+	// the same as the one before it, which catches anything that animates without the window knowing.
+	if (invalidated || lastFrameChanged || !state_ || !state_->CanSkipDraw())
+	{
+		return true;
+	}
+	return !frozenGraphics.empty() && frozenGraphics.top().fadeTicks <= maxFadeTicks;
+}
+
 void Engine::onKeyPress(int key, int scan, bool repeat, bool shift, bool ctrl, bool alt)
 {
+	invalidated = true;
 	if (state_ && !ignoreEvents)
 		state_->DoKeyPress(key, scan, repeat, shift, ctrl, alt);
 }
 
 void Engine::onKeyRelease(int key, int scan, bool repeat, bool shift, bool ctrl, bool alt)
 {
+	invalidated = true;
 	if (state_ && !ignoreEvents)
 		state_->DoKeyRelease(key, scan, repeat, shift, ctrl, alt);
 }
 
 void Engine::onTextInput(String text)
 {
+	invalidated = true;
 	if (textInput)
 	{
 		if (state_ && !ignoreEvents)
@@ -254,6 +271,7 @@ void Engine::onTextInput(String text)
 
 void Engine::onTextEditing(String text, int start)
 {
+	invalidated = true;
 	if (textInput)
 	{
 		// * SDL sends the candidate string in packets of some arbitrary size,
@@ -286,6 +304,7 @@ void Engine::onTextEditing(String text, int start)
 
 void Engine::onMouseDown(int x, int y, unsigned button)
 {
+	invalidated = true;
 	mouseb_ |= button;
 	if (state_ && !ignoreEvents)
 		state_->DoMouseDown(x, y, button);
@@ -293,6 +312,7 @@ void Engine::onMouseDown(int x, int y, unsigned button)
 
 void Engine::onMouseUp(int x, int y, unsigned button)
 {
+	invalidated = true;
 	mouseb_ &= ~button;
 	if (state_ && !ignoreEvents)
 		state_->DoMouseUp(x, y, button);
@@ -306,6 +326,7 @@ void Engine::initialMouse(int x, int y)
 
 void Engine::onMouseMove(int x, int y)
 {
+	invalidated = true;
 	mousex_ = x;
 	mousey_ = y;
 	if (state_ && !ignoreEvents)
@@ -318,18 +339,21 @@ void Engine::onMouseMove(int x, int y)
 
 void Engine::onMouseWheel(int x, int y, int delta)
 {
+	invalidated = true;
 	if (state_ && !ignoreEvents)
 		state_->DoMouseWheel(x, y, delta);
 }
 
 void Engine::onClose()
 {
+	invalidated = true;
 	if (state_)
 		state_->DoExit();
 }
 
 void Engine::onFileDrop(ByteString filename)
 {
+	invalidated = true;
 	if (state_)
 		state_->DoFileDrop(filename);
 }
@@ -378,6 +402,7 @@ std::optional<int> Engine::GetEffectiveDrawCap() const
 
 void Engine::SetFps(float newFps)
 {
+	invalidated = true;
 	if (state_)
 	{
 		return state_->SetFps(newFps);
@@ -70,6 +70,10 @@ namespace ui
 		void Tick();
 		void SimTick();
 		void Draw();
+		// Whether the next frame may look different from the last one drawn
+		bool NeedsDraw() const;
+		// For the platform layer, after it has presented a frame
+		void SetLastFrameChanged(bool changed) { lastFrameChanged = changed; }
 
 		void SetFps(float newFps);
 		float GetFps() const;
@@ -109,6 +113,8 @@ namespace ui
 		Point windowTargetPosition;
 		bool ignoreEvents = false;
 		RefreshRate refreshRate;
+		bool invalidated = true; // input or a change of windows since the last Draw
+		bool lastFrameChanged = true;
 
 		// saved appearances of windows that are in the backround and
 		// thus are not currently being redrawn
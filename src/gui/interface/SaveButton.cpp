@@ -141,7 +141,7 @@ void SaveButton::Tick()
 			}
 			else if (file && file->GetGameSave())
 			{
-				thumbnailRenderer = new ThumbnailRendererTask(*file->GetGameSave(), thumbBoxSize, RendererSettings::decorationEnabled, false);
+				thumbnailRenderer = new ThumbnailRendererTask(*file->GetGameSave(), thumbBoxSize, RendererSettings::decorationEnabled, false, file->GetContentHash());
 				thumbnailRenderer->Start();
 				triedThumbnail = true;
 			}
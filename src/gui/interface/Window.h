@@ -72,6 +72,10 @@ namespace ui
 		virtual void DoTextInput(String text);
 		virtual void DoTextEditing(String text);
 
+		// Whether the window looks the same from one frame to the next as long as it gets no input, so that the Engine
+		// may skip drawing it; see Engine::NeedsDraw
+		virtual bool CanSkipDraw() const { return false; }
+
 		// Sets halt and destroy, this causes the Windows to stop sending events and remove itself.
 		void SelfDestruct();
 		void Halt();
@@ -848,6 +848,13 @@ void OptionsView::OnTick()
 	UpdateStartupRequestStatus();
 }
 
+bool OptionsView::CanSkipDraw() const
+{
+	// the startup request status label follows the request, and textboxes repeat held keys by themselves
+	auto textInput = focusedComponent_ && focusedComponent_->DoesTextInput;
+	return Client::Ref().GetStartupRequestStatus() != Client::StartupRequestStatus::inProgress && !textInput;
+}
+
 void OptionsView::OnDraw()
 {
 	Graphics * g = GetGraphics();
@@ -79,5 +79,6 @@ public:
 	void AttachController(OptionsController * c_);
 	void OnDraw() override;
 	void OnTick() final override;
+	bool CanSkipDraw() const override;
 	void OnTryExit(ExitMethod method) override;
 };
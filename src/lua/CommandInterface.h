@@ -35,6 +35,8 @@ public:
 
 	bool HandleEvent(const GameControllerEvent &event);
 	bool HaveSimGraphicsEventHandlers();
+	// Whether scripts want OnTick and the draw events even while nothing else changes
+	bool HaveTickWork();
 
 	int Command(String command);
 	String FormatCommand(String command);
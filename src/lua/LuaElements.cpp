@@ -450,11 +450,13 @@ static int element(lua_State *L)
 			{
 				customElements[id].graphics.Assign(L, -1);
 				elements[id].Graphics = luaGraphicsWrapper;
+				elements[id].GraphicsDependsOn = 0;
 			}
 			else if (lua_type(L, -1) == LUA_TBOOLEAN && !lua_toboolean(L, -1))
 			{
 				customElements[id].graphics.Clear();
 				elements[id].Graphics = builtinElements[id].Graphics;
+				elements[id].GraphicsDependsOn = builtinElements[id].GraphicsDependsOn;
 			}
 			lua_pop(L, 1);
 
@@ -622,11 +624,14 @@ static int property(lua_State *L)
 			{
 				customElements[id].graphics.Assign(L, 3);
 				elements[id].Graphics = luaGraphicsWrapper;
+				// optional mask of the particle fields (bit.lshift(1, sim.FIELD_*)) the function reads; see Element::GraphicsDependsOn
+				elements[id].GraphicsDependsOn = luaL_optint(L, 4, 0);
 			}
 			else if (lua_type(L, 3) == LUA_TBOOLEAN && !lua_toboolean(L, 3))
 			{
 				customElements[id].graphics.Clear();
 				elements[id].Graphics = builtinElements[id].Graphics;
+				elements[id].GraphicsDependsOn = builtinElements[id].GraphicsDependsOn;
 			}
 			sd.graphicscache[id].isready = 0;
 		}
@@ -164,10 +164,11 @@ static int record(lua_State *L)
 {
 	auto *lsi = GetLSI();
 	lsi->AssertInterfaceEvent();
-	if (!lua_isboolean(L, -1))
+	if (!lua_isboolean(L, 1))
 		return luaL_typerror(L, 1, lua_typename(L, LUA_TBOOLEAN));
-	bool record = lua_toboolean(L, -1);
-	int recordingFolder = lsi->gameController->Record(record);
+	bool record = lua_toboolean(L, 1);
+	int fileType = luaL_optint(L, 2, 0);
+	int recordingFolder = lsi->gameController->Record(record, fileType);
 	lua_pushinteger(L, recordingFolder);
 	return 1;
 }
@@ -84,10 +84,20 @@ static int mathRandomseed(lua_State *L)
 static void hook(lua_State *L, lua_Debug * ar)
 {
 	auto *lsi = GetLSI();
-	if (ar->event == LUA_HOOKCOUNT && int(Platform::GetTime() - lsi->luaExecutionStart) > lsi->luaHookTimeout)
+	if (ar->event != LUA_HOOKCOUNT)
 	{
+		return;
+	}
+	// the clock is only read once a call has been running for a while, most callbacks never get here
+	auto now = Platform::GetTime();
+	if (!lsi->luaExecutionStart)
+	{
+		lsi->luaExecutionStart = now;
+	}
+	else if (int(now - *lsi->luaExecutionStart) > lsi->luaHookTimeout)
+	{
+		lsi->luaExecutionStart.reset();
 		luaL_error(L, "Error: Script not responding");
-		lsi->luaExecutionStart = Platform::GetTime();
 	}
 }
 
@@ -493,20 +503,20 @@ void LuaScriptInterface::RemoveEventHandler(int eventType, int stackIndex)
 }
 
 template<size_t Index>
-std::enable_if_t<Index != std::variant_size_v<GameControllerEvent>, bool> HaveSimGraphicsEventHandlersHelper(const auto &gameControllerEventHandlers)
+std::enable_if_t<Index != std::variant_size_v<GameControllerEvent>, bool> HaveEventHandlersHelper(const auto &gameControllerEventHandlers, EventTraits traits)
 {
-	if (std::variant_alternative_t<Index, GameControllerEvent>::traits & eventTraitHindersSrt)
+	if (std::variant_alternative_t<Index, GameControllerEvent>::traits & traits)
 	{
 		if (!gameControllerEventHandlers[Index].empty())
 		{
 			return true;
 		}
 	}
-	return HaveSimGraphicsEventHandlersHelper<Index + 1>(gameControllerEventHandlers);
+	return HaveEventHandlersHelper<Index + 1>(gameControllerEventHandlers, traits);
 }
 
 template<size_t Index>
-std::enable_if_t<Index == std::variant_size_v<GameControllerEvent>, bool> HaveSimGraphicsEventHandlersHelper(const auto &gameControllerEventHandlers)
+std::enable_if_t<Index == std::variant_size_v<GameControllerEvent>, bool> HaveEventHandlersHelper(const auto &gameControllerEventHandlers, EventTraits traits)
 {
 	return false;
 }
@@ -522,7 +532,17 @@ bool CommandInterface::HaveSimGraphicsEventHandlers()
 			return true;
 		}
 	}
-	return HaveSimGraphicsEventHandlersHelper<0>(lsi->gameControllerEventHandlers);
+	return HaveEventHandlersHelper<0>(lsi->gameControllerEventHandlers, eventTraitHindersSrt);
+}
+
+bool CommandInterface::HaveTickWork()
+{
+	auto *lsi = static_cast<LuaScriptInterface *>(this);
+	if (lsi->scriptManagerDownload || !lsi->requestHandles.empty())
+	{
+		return true;
+	}
+	return HaveEventHandlersHelper<0>(lsi->gameControllerEventHandlers, eventTraitSimGraphics | eventTraitInterfaceGraphics);
 }
 
 void CommandInterface::OnTick()
@@ -877,7 +897,7 @@ bool tpt_lua_equalsString(lua_State *L, int index, const char *data, size_t size
 int tpt_lua_pcall(lua_State *L, int numArgs, int numResults, int errorFunc, EventTraits newEventTraits)
 {
 	auto *lsi = GetLSI();
-	lsi->luaExecutionStart = Platform::GetTime();
+	lsi->luaExecutionStart.reset();
 	struct AtReturn
 	{
 		EventTraits oldEventTraits;
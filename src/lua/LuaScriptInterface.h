@@ -9,6 +9,7 @@
 #include <cstdint>
 #include <map>
 #include <memory>
+#include <optional>
 #include <list>
 #include <deque>
 
@@ -137,7 +138,7 @@ public:
 	String lastCode;
 
 	int textInputRefcount = 0;
-	long unsigned int luaExecutionStart = 0;
+	std::optional<long unsigned int> luaExecutionStart; // set by the instruction count hook, see tpt_lua_pcall
 	int monopartAccessPartID = -1;
 
 private:
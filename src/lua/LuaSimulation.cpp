@@ -2041,6 +2041,19 @@ static int ensureDeterminism(lua_State *L)
 	return 1;
 }
 
+static int sortInterval(lua_State *L)
+{
+	auto *lsi = GetLSI();
+	lsi->AssertInterfaceEvent();
+	if (lua_gettop(L))
+	{
+		lsi->sim->sortInterval = std::max(luaL_checkint(L, 1), 0);
+		return 0;
+	}
+	lua_pushinteger(L, lsi->sim->sortInterval);
+	return 1;
+}
+
 void LuaSimulation::Open(lua_State *L)
 {
 	auto *lsi = GetLSI();
@@ -2125,6 +2138,7 @@ void LuaSimulation::Open(lua_State *L)
 		LFUNC(randomSeed),
 		LFUNC(hash),
 		LFUNC(ensureDeterminism),
+		LFUNC(sortInterval),
 		LFUNC(paused),
 		LFUNC(gravityMass),
 		LFUNC(gravityMask),
@@ -1,6 +1,5 @@
 #include "Simulation.h"
 #include "Sample.h"
-#include "Snapshot.h"
 #include "Air.h"
 #include "gravity/Gravity.h"
 #include "common/tpt-rand.h"
@@ -11,78 +10,6 @@
 #include <iostream>
 #include <cmath>
 
-std::unique_ptr<Snapshot> Simulation::CreateSnapshot() const
-{
-	auto snap = std::make_unique<Snapshot>();
-	snap->AirPressure    .insert   (snap->AirPressure    .begin(), &pv  [0][0]      , &pv  [0][0] + NCELL);
-	snap->AirVelocityX   .insert   (snap->AirVelocityX   .begin(), &vx  [0][0]      , &vx  [0][0] + NCELL);
-	snap->AirVelocityY   .insert   (snap->AirVelocityY   .begin(), &vy  [0][0]      , &vy  [0][0] + NCELL);
-	snap->AmbientHeat    .insert   (snap->AmbientHeat    .begin(), &hv  [0][0]      , &hv  [0][0] + NCELL);
-	snap->BlockMap       .insert   (snap->BlockMap       .begin(), &bmap[0][0]      , &bmap[0][0] + NCELL);
-	snap->ElecMap        .insert   (snap->ElecMap        .begin(), &emap[0][0]      , &emap[0][0] + NCELL);
-	snap->BlockAir       .insert   (snap->BlockAir       .begin(), &air->bmap_blockair[0][0] , &air->bmap_blockair[0][0]  + NCELL);
-	snap->BlockAirH      .insert   (snap->BlockAirH      .begin(), &air->bmap_blockairh[0][0], &air->bmap_blockairh[0][0] + NCELL);
-	snap->FanVelocityX   .insert   (snap->FanVelocityX   .begin(), &fvx [0][0]      , &fvx [0][0] + NCELL);
-	snap->FanVelocityY   .insert   (snap->FanVelocityY   .begin(), &fvy [0][0]      , &fvy [0][0] + NCELL);
-	snap->Particles      .insert   (snap->Particles      .begin(), &parts  [0]      , &parts  [0] + parts.active);
-	snap->PortalParticles.insert   (snap->PortalParticles.begin(), &portalp[0][0][0], &portalp[0][0][0] + CHANNELS * 8 * 80);
-	snap->WirelessData   .insert   (snap->WirelessData   .begin(), &wireless[0][0]  , &wireless[0][0] + CHANNELS * 2);
-	snap->stickmen       .insert   (snap->stickmen       .begin(), &fighters[0]     , &fighters[0] + MAX_FIGHTERS);
-	snap->stickmen       .push_back(player2);
-	snap->stickmen       .push_back(player);
-	snap->GravMass  .insert(snap->GravMass  .begin(), &gravIn.mass[{ 0, 0 }]   , &gravIn.mass[{ 0, 0 }]    + NCELL);
-	snap->GravMask  .insert(snap->GravMask  .begin(), &gravIn.mask[{ 0, 0 }]   , &gravIn.mask[{ 0, 0 }]    + NCELL);
-	snap->GravForceX.insert(snap->GravForceX.begin(), &gravOut.forceX[{ 0, 0 }], &gravOut.forceX[{ 0, 0 }] + NCELL);
-	snap->GravForceY.insert(snap->GravForceY.begin(), &gravOut.forceY[{ 0, 0 }], &gravOut.forceY[{ 0, 0 }] + NCELL);
-	snap->signs = signs;
-	snap->FrameCount = frameCount;
-	snap->RngState = rng.state();
-	return snap;
-}
-
-void Simulation::Restore(const Snapshot &snap)
-{
-	std::fill(elementCount, elementCount + PT_NUM, 0);
-	elementRecount = true;
-	force_stacking_check = true;
-	for (auto &part : parts.data)
-	{
-		part.type = 0;
-	}
-	std::copy(snap.AirPressure    .begin(), snap.AirPressure    .end(), &pv[0][0]        );
-	std::copy(snap.AirVelocityX   .begin(), snap.AirVelocityX   .end(), &vx[0][0]        );
-	std::copy(snap.AirVelocityY   .begin(), snap.AirVelocityY   .end(), &vy[0][0]        );
-	std::copy(snap.AmbientHeat    .begin(), snap.AmbientHeat    .end(), &hv[0][0]        );
-	std::copy(snap.BlockMap       .begin(), snap.BlockMap       .end(), &bmap[0][0]      );
-	std::copy(snap.ElecMap        .begin(), snap.ElecMap        .end(), &emap[0][0]      );
-	std::copy(snap.BlockAir       .begin(), snap.BlockAir       .end(), &air->bmap_blockair[0][0] );
-	std::copy(snap.BlockAirH      .begin(), snap.BlockAirH      .end(), &air->bmap_blockairh[0][0]);
-	std::copy(snap.FanVelocityX   .begin(), snap.FanVelocityX   .end(), &fvx[0][0]       );
-	std::copy(snap.FanVelocityY   .begin(), snap.FanVelocityY   .end(), &fvy[0][0]       );
-	std::copy(snap.Particles      .begin(), snap.Particles      .end(), &parts[0]        );
-	std::copy(snap.PortalParticles.begin(), snap.PortalParticles.end(), &portalp[0][0][0]);
-	std::copy(snap.WirelessData   .begin(), snap.WirelessData   .end(), &wireless[0][0]  );
-	std::copy(snap.stickmen       .begin(), snap.stickmen.end() - 2   , &fighters[0]     );
-	player  = snap.stickmen[snap.stickmen.size() - 1];
-	player2 = snap.stickmen[snap.stickmen.size() - 2];
-	{
-		GravityInput newGravIn;
-		GravityOutput newGravOut;
-		std::copy(snap.GravMass  .begin(), snap.GravMass  .end(), &newGravIn.mass[{ 0, 0 }]   );
-		std::copy(snap.GravMask  .begin(), snap.GravMask  .end(), &newGravIn.mask[{ 0, 0 }]   );
-		std::copy(snap.GravForceX.begin(), snap.GravForceX.end(), &newGravOut.forceX[{ 0, 0 }]);
-		std::copy(snap.GravForceY.begin(), snap.GravForceY.end(), &newGravOut.forceY[{ 0, 0 }]);
-		// we apply the old grav values but Newtonian gravity enable state is not part of the snapshot so this may be pointless
-		// TODO: maybe track settings like Newtonian gravity enable state in the history
-		ResetNewtonianGravity(newGravIn, newGravOut);
-	}
-	signs = snap.signs;
-	frameCount = snap.FrameCount;
-	rng.state(snap.RngState);
-	parts.active = NPART;
-	RecalcFreeParticles(false);
-}
-
 void Simulation::clear_area(int area_x, int area_y, int area_w, int area_h)
 {
 	auto intersection = RES.OriginRect() & RectSized(Vec2{ area_x, area_y }, Vec2{ area_w, area_h });
@@ -57,6 +57,12 @@ public:
 
 	int (*Update) (UPDATE_FUNC_ARGS);
 	int (*Graphics) (GRAPHICS_FUNC_ARGS);
+	// Particle fields (1U << FIELD_*) that Graphics reads. If nonzero, Graphics promises not to depend on anything else
+	// that changes during a frame, so the renderer reuses its results for particles of this type that agree on these fields.
+	// Float fields such as temp hardly ever agree exactly, so they only have to fall into the same bucket of
+	// Renderer::graphicsMemoFloatBucket units; particles in one bucket get the results of whichever was drawn first.
+	// Only worth it for expensive functions such as Lua callbacks; a lookup costs about as much as a typical native one.
+	unsigned int GraphicsDependsOn = 0;
 
 	void (*Create)(ELEMENT_CREATE_FUNC_ARGS) = nullptr;
 	bool (*CreateAllowed)(ELEMENT_CREATE_ALLOWED_FUNC_ARGS) = nullptr;
@@ -0,0 +1,51 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+
+// * A LazyArray holds a fixed-size, possibly multidimensional array that is only allocated once it
+//   is accessed through Get or operator [], for big Simulation buffers that most saves never use.
+//   Release frees the memory again. An array that isn't allocated reads as all zeroes, which is
+//   also what a newly allocated one holds.
+// * operator [] allocates even if it is only used to read. Code that only reads should use Peek,
+//   which returns nullptr rather than allocating, or check Allocated first. Code that accesses the
+//   array in a hot loop should call Get once outside the loop rather than go through operator []
+//   every time.
+template<class Array>
+class LazyArray
+{
+	struct Storage
+	{
+		Array data;
+	};
+	std::unique_ptr<Storage> storage;
+
+public:
+	bool Allocated() const
+	{
+		return bool(storage);
+	}
+
+	Array &Get()
+	{
+		if (!storage)
+		{
+			storage = std::make_unique<Storage>();
+		}
+		return storage->data;
+	}
+
+	const Array *Peek() const
+	{
+		return storage ? &storage->data : nullptr;
+	}
+
+	void Release()
+	{
+		storage.reset();
+	}
+
+	auto &operator [](size_t i)
+	{
+		return Get()[i];
+	}
+};
@@ -8,21 +8,52 @@
 #include "Simulation.h"
 #include "SimulationData.h"
 
+#include "common/Defer.h"
+
 SaveRenderer::SaveRenderer()
 {
-	sim = Simulation::Factory();
-	ren = std::make_unique<Renderer>();
-	ren->sim = sim.get();
+	idleInstances.push_back(MakeInstance());
 }
 
 SaveRenderer::~SaveRenderer() = default;
 
+std::unique_ptr<SaveRenderer::Instance> SaveRenderer::MakeInstance()
+{
+	auto instance = std::make_unique<Instance>();
+	instance->sim = Simulation::Factory();
+	instance->ren = std::make_unique<Renderer>();
+	instance->ren->sim = instance->sim.get();
+	return instance;
+}
+
 std::unique_ptr<VideoBuffer> SaveRenderer::Render(const GameSave *save, bool fire, RendererSettings rendererSettings)
 {
 	// this function usually runs on a thread different from where element info in SimulationData may be written, so we acquire a read-only lock on it
 	auto &sd = SimulationData::CRef();
 	std::shared_lock lk(sd.elementGraphicsMx);
-	std::lock_guard<std::mutex> gx(renderMutex);
+	std::unique_ptr<Instance> instance;
+	{
+		std::lock_guard g(idleInstancesMx);
+		if (!idleInstances.empty())
+		{
+			instance = std::move(idleInstances.back());
+			idleInstances.pop_back();
+		}
+	}
+	if (!instance)
+	{
+		instance = MakeInstance();
+	}
+	Defer returnInstance([this, &instance]() {
+		std::lock_guard g(idleInstancesMx);
+		if (idleInstances.size() < maxIdleInstances)
+		{
+			idleInstances.push_back(std::move(instance));
+		}
+		// otherwise, instance is freed when it goes out of scope, after the lock is released
+	});
+	auto *sim = instance->sim.get();
+	auto *ren = instance->ren.get();
 
 	ren->ApplySettings(rendererSettings);
 
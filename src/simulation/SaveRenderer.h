@@ -14,9 +14,19 @@ class Renderer;
 
 class SaveRenderer: public ExplicitSingleton<SaveRenderer>
 {
-	std::unique_ptr<Simulation> sim;
-	std::unique_ptr<Renderer> ren;
-	std::mutex renderMutex;
+	// Simulation and Renderer instances are independent of one another, so every Render call takes
+	// one for itself and concurrent calls don't wait for each other. Up to maxIdleInstances are kept
+	// for reuse; each is tens of megabytes, so ones beyond that are freed once their call returns.
+	struct Instance
+	{
+		std::unique_ptr<Simulation> sim;
+		std::unique_ptr<Renderer> ren;
+	};
+	static constexpr size_t maxIdleInstances = 2;
+	std::vector<std::unique_ptr<Instance>> idleInstances;
+	std::mutex idleInstancesMx;
+
+	std::unique_ptr<Instance> MakeInstance();
 
 public:
 	SaveRenderer();
@@ -5,6 +5,7 @@
 #include "gravity/Gravity.h"
 #include "ToolClasses.h"
 #include "SimulationData.h"
+#include "Snapshot.h"
 #include "client/GameSave.h"
 #include "common/tpt-rand.h"
 #include "common/Defer.h"
@@ -17,6 +18,7 @@
 #include "elements/FILT.h"
 #include "elements/PRTI.h"
 #include "elements/PLNT.h"
+#include <algorithm>
 #include <iostream>
 #include <numbers>
 #include <set>
@@ -499,6 +501,118 @@ void Simulation::SaveSimOptions(GameSave &gameSave)
 	gameSave.aheatEnable = aheat_enable;
 }
 
+void Simulation::LoadSimOptions(const GameSave &gameSave)
+{
+	gravityMode = gameSave.gravityMode;
+	customGravityX = gameSave.customGravityX;
+	customGravityY = gameSave.customGravityY;
+	air->airMode = gameSave.airMode;
+	air->ambientAirTemp = gameSave.ambientAirTemp;
+	air->edgePressure = gameSave.edgePressure;
+	air->edgeVelocityX = gameSave.edgeVelocityX;
+	air->edgeVelocityY = gameSave.edgeVelocityY;
+	air->vorticityCoeff = gameSave.vorticityCoeff;
+	air->convectionMode = gameSave.convectionMode;
+	edgeMode = gameSave.edgeMode;
+	legacy_enable = gameSave.legacyEnable;
+	water_equal_test = gameSave.waterEEnabled;
+	aheat_enable = gameSave.aheatEnable;
+	EnableNewtonianGravity(gameSave.gravityEnable);
+	frameCount = gameSave.frameCount;
+	if (gameSave.hasRngState)
+	{
+		rng.state(gameSave.rngState);
+	}
+	else
+	{
+		rng = RNG();
+	}
+	ensureDeterminism = gameSave.ensureDeterminism;
+}
+
+std::unique_ptr<Snapshot> Simulation::CreateSnapshot(const Snapshot *shareWith) const
+{
+	auto snap = std::make_unique<Snapshot>();
+	// tiles identical to those in shareWith are shared rather than copied, see SnapshotPlane
+	auto base = [shareWith](auto Snapshot::*plane) {
+		return shareWith ? &(shareWith->*plane) : nullptr;
+	};
+	snap->AirPressure    .Assign(&pv  [0][0]      , NCELL                , base(&Snapshot::AirPressure    ));
+	snap->AirVelocityX   .Assign(&vx  [0][0]      , NCELL                , base(&Snapshot::AirVelocityX   ));
+	snap->AirVelocityY   .Assign(&vy  [0][0]      , NCELL                , base(&Snapshot::AirVelocityY   ));
+	snap->AmbientHeat    .Assign(&hv  [0][0]      , NCELL                , base(&Snapshot::AmbientHeat    ));
+	snap->BlockMap       .Assign(&bmap[0][0]      , NCELL                , base(&Snapshot::BlockMap       ));
+	snap->ElecMap        .Assign(&emap[0][0]      , NCELL                , base(&Snapshot::ElecMap        ));
+	snap->BlockAir       .Assign(&air->bmap_blockair[0][0] , NCELL       , base(&Snapshot::BlockAir       ));
+	snap->BlockAirH      .Assign(&air->bmap_blockairh[0][0], NCELL       , base(&Snapshot::BlockAirH      ));
+	snap->FanVelocityX   .Assign(&fvx [0][0]      , NCELL                , base(&Snapshot::FanVelocityX   ));
+	snap->FanVelocityY   .Assign(&fvy [0][0]      , NCELL                , base(&Snapshot::FanVelocityY   ));
+	snap->Particles      .Assign(&parts  [0]      , parts.active         , base(&Snapshot::Particles      ));
+	auto *portalpData = portalp.Peek();
+	snap->PortalParticles.Assign(portalpData ? &(*portalpData)[0][0][0] : nullptr, CHANNELS * 8 * 80, base(&Snapshot::PortalParticles));
+	snap->GravMass       .Assign(&gravIn.mass[{ 0, 0 }]   , NCELL        , base(&Snapshot::GravMass       ));
+	snap->GravMask       .Assign(&gravIn.mask[{ 0, 0 }]   , NCELL        , base(&Snapshot::GravMask       ));
+	snap->GravForceX     .Assign(&gravOut.forceX[{ 0, 0 }], NCELL        , base(&Snapshot::GravForceX     ));
+	snap->GravForceY     .Assign(&gravOut.forceY[{ 0, 0 }], NCELL        , base(&Snapshot::GravForceY     ));
+	snap->WirelessData   .insert   (snap->WirelessData   .begin(), &wireless[0][0]  , &wireless[0][0] + CHANNELS * 2);
+	snap->stickmen       .insert   (snap->stickmen       .begin(), &fighters[0]     , &fighters[0] + MAX_FIGHTERS);
+	snap->stickmen       .push_back(player2);
+	snap->stickmen       .push_back(player);
+	snap->signs = signs;
+	snap->FrameCount = frameCount;
+	snap->RngState = rng.state();
+	return snap;
+}
+
+void Simulation::Restore(const Snapshot &snap)
+{
+	std::fill(elementCount, elementCount + PT_NUM, 0);
+	elementRecount = true;
+	force_stacking_check = true;
+	// everything past parts.active is already empty, only the tail that the snapshot doesn't cover needs clearing
+	auto snapActive = int(snap.Particles.size());
+	for (auto i = snapActive; i < parts.active; i++)
+	{
+		parts[i].type = 0;
+	}
+	snap.AirPressure    .CopyTo(&pv[0][0]        );
+	snap.AirVelocityX   .CopyTo(&vx[0][0]        );
+	snap.AirVelocityY   .CopyTo(&vy[0][0]        );
+	snap.AmbientHeat    .CopyTo(&hv[0][0]        );
+	snap.BlockMap       .CopyTo(&bmap[0][0]      );
+	snap.ElecMap        .CopyTo(&emap[0][0]      );
+	snap.BlockAir       .CopyTo(&air->bmap_blockair[0][0] );
+	snap.BlockAirH      .CopyTo(&air->bmap_blockairh[0][0]);
+	snap.FanVelocityX   .CopyTo(&fvx[0][0]       );
+	snap.FanVelocityY   .CopyTo(&fvy[0][0]       );
+	snap.Particles      .CopyTo(&parts[0]        );
+	// don't allocate portalp just to fill it with zeroes; CreateSnapshot leaves the plane all zero tiles if it wasn't allocated
+	if (snap.PortalParticles.AllZeroTiles())
+		portalp.Release();
+	else
+		snap.PortalParticles.CopyTo(&portalp.Get()[0][0][0]);
+	std::copy(snap.WirelessData   .begin(), snap.WirelessData   .end(), &wireless[0][0]  );
+	std::copy(snap.stickmen       .begin(), snap.stickmen.end() - 2   , &fighters[0]     );
+	player  = snap.stickmen[snap.stickmen.size() - 1];
+	player2 = snap.stickmen[snap.stickmen.size() - 2];
+	{
+		GravityInput newGravIn;
+		GravityOutput newGravOut;
+		snap.GravMass  .CopyTo(&newGravIn.mass[{ 0, 0 }]   );
+		snap.GravMask  .CopyTo(&newGravIn.mask[{ 0, 0 }]   );
+		snap.GravForceX.CopyTo(&newGravOut.forceX[{ 0, 0 }]);
+		snap.GravForceY.CopyTo(&newGravOut.forceY[{ 0, 0 }]);
+		// we apply the old grav values but Newtonian gravity enable state is not part of the snapshot so this may be pointless
+		// TODO: maybe track settings like Newtonian gravity enable state in the history
+		ResetNewtonianGravity(newGravIn, newGravOut);
+	}
+	signs = snap.signs;
+	frameCount = snap.FrameCount;
+	rng.state(snap.RngState);
+	parts.active = snapActive;
+	RecalcFreeParticles(false);
+}
+
 bool Simulation::FloodFillPmapCheck(int x, int y, int type) const
 {
 	auto &sd = SimulationData::CRef();
@@ -1033,19 +1147,20 @@ void Simulation::clear_sim(void)
 	memset(bmap, 0, sizeof(bmap));
 	memset(emap, 0, sizeof(emap));
 	parts.Reset();
+	partsByTypeStale.set();
 	NUM_PARTS = 0;
 	memset(pmap, 0, sizeof(pmap));
 	memset(fvx, 0, sizeof(fvx));
 	memset(fvy, 0, sizeof(fvy));
 	memset(photons, 0, sizeof(photons));
 	memset(wireless, 0, sizeof(wireless));
-	memset(gol, 0, sizeof(gol));
-	memset(portalp, 0, sizeof(portalp));
+	gol.Release();
+	portalp.Release();
 	memset(fighters, 0, sizeof(fighters));
 	memset(&player, 0, sizeof(player));
 	memset(&player2, 0, sizeof(player2));
-	memset(&Element_LOLZ_lolz, 0, sizeof(Element_LOLZ_lolz));
-	memset(&Element_LOVE_love, 0, sizeof(Element_LOVE_love));
+	Element_LOLZ_lolz.Release();
+	Element_LOVE_love.Release();
 	memset(&Element_PSTN_tempParts, 0, sizeof(Element_PSTN_tempParts));
 	Element_PPIP_ppip_changed = 0;
 	std::fill(elementCount, elementCount+PT_NUM, 0);
@@ -1635,9 +1750,9 @@ int Simulation::is_boundary(int pt, int x, int y) const
 
 int Simulation::find_next_boundary(int pt, int *x, int *y, int dm, int *em, bool reverse) const
 {
-	static int dx[8] = {1,1,0,-1,-1,-1,0,1};
-	static int dy[8] = {0,1,1,1,0,-1,-1,-1};
-	static int de[8] = {0x83,0x07,0x0E,0x1C,0x38,0x70,0xE0,0xC1};
+	static const int dx[8] = {1,1,0,-1,-1,-1,0,1};
+	static const int dy[8] = {0,1,1,1,0,-1,-1,-1};
+	static const int de[8] = {0x83,0x07,0x0E,0x1C,0x38,0x70,0xE0,0xC1};
 
 	if (*x <= 0 || *x >= XRES-1 || *y <= 0 || *y >= YRES-1)
 	{
@@ -1817,6 +1932,7 @@ bool Simulation::part_change_type(int i, int x, int y, int t)
 		(*(elements[parts[i].type].ChangeType))(this, i, x, y, parts[i].type, t);
 	if (elements[t].ChangeType)
 		(*(elements[t].ChangeType))(this, i, x, y, parts[i].type, t);
+	partsByTypeStale[t] = true;
 
 	if (parts[i].type > 0 && parts[i].type < PT_NUM && elementCount[parts[i].type])
 		elementCount[parts[i].type]--;
@@ -1848,6 +1964,7 @@ int Simulation::create_part(int p, int x, int y, int t, int v)
 	auto &elements = sd.elements;
 	if (x<0 || y<0 || x>=XRES || y>=YRES || t<=0 || t>=PT_NUM || !elements[t].Enabled)
 		return -1;
+	partsByTypeStale[t] = true;
 
 	if (t == PT_SPRK && p != -3 && !(p == -2 && elements[TYP(pmap[y][x])].CtypeDraw))
 	{
@@ -2082,6 +2199,29 @@ void Simulation::create_cherenkov_photon(int pp)//photons from NEUT going throug
 	parts[i].vy *= r;
 }
 
+// Radial gravity only depends on position, so the field it yields for particleGrav = 1 is computed
+// once per pixel instead of in every GetGravityField call. The products in GetGravityField are
+// the same as if the division had been done there, so results don't change.
+using RadialGravityPlane = PlaneAdapter<std::vector<Vec2<float>>, XRES, YRES>;
+static const RadialGravityPlane &RadialGravityField()
+{
+	static const auto field = []() {
+		RadialGravityPlane field(RES, Vec2<float>(0.f, 0.f));
+		for (auto p : RES.OriginRect())
+		{
+			auto dx = float(p.X - XCNTR);
+			auto dy = float(p.Y - YCNTR);
+			if (dx || dy)
+			{
+				auto pGravD = 0.01f - hypotf(dx, dy);
+				field[p] = Vec2<float>(dx / pGravD, dy / pGravD);
+			}
+		}
+		return field;
+	}();
+	return field;
+}
+
 void Simulation::GetGravityField(int x, int y, float particleGrav, float newtonGrav, float & pGravX, float & pGravY) const
 {
 	switch (gravityMode)
@@ -2099,13 +2239,22 @@ void Simulation::GetGravityField(int x, int y, float particleGrav, float newtonG
 		{
 			pGravX = 0;
 			pGravY = 0;
-			auto dx = float(x - XCNTR);
-			auto dy = float(y - YCNTR);
-			if (dx || dy)
+			if (x != XCNTR || y != YCNTR)
 			{
-				auto pGravD = 0.01f - hypotf(dx, dy);
-				pGravX = particleGrav * (dx / pGravD);
-				pGravY = particleGrav * (dy / pGravD);
+				if (InBounds(x, y))
+				{
+					auto unit = RadialGravityField()[Vec2{ x, y }];
+					pGravX = particleGrav * unit.X;
+					pGravY = particleGrav * unit.Y;
+				}
+				else
+				{
+					auto dx = float(x - XCNTR);
+					auto dy = float(y - YCNTR);
+					auto pGravD = 0.01f - hypotf(dx, dy);
+					pGravX = particleGrav * (dx / pGravD);
+					pGravY = particleGrav * (dy / pGravD);
+				}
 			}
 		}
 		break;
@@ -2584,6 +2733,7 @@ bool SimulationImpl::TransitionPhase(int i, const Neighbourhood &neighbourhood)
 						{
 							t = PT_LAVA;
 							parts[i].type = PT_TUNG;
+							partsByTypeStale[PT_TUNG] = true;
 						}
 					}
 					else if (ctemph >= elements[t].HighTemperature)
@@ -3364,6 +3514,13 @@ void Simulation::RecalcFreeParticles(bool do_life_dec)
 	memset(pmap, 0, sizeof(pmap));
 	memset(pmap_count, 0, sizeof(pmap_count));
 	memset(photons, 0, sizeof(photons));
+	stackingCandidates.clear();
+
+	for (auto &ids : partsByType)
+	{
+		ids.clear();
+	}
+	partsByTypeStale.reset();
 
 	NUM_PARTS = 0;
 	auto &sd = SimulationData::CRef();
@@ -3391,7 +3548,11 @@ void Simulation::RecalcFreeParticles(bool do_life_dec)
 					pmap[y][x] = PMAP(i, t);
 				// (there are a few exceptions, including energy particles - currently no limit on stacking those)
 				if (t!=PT_THDR && t!=PT_EMBR && t!=PT_FIGH && t!=PT_PLSM)
+				{
 					pmap_count[y][x]++;
+					if (pmap_count[y][x] == stackingThreshold + 1)
+						stackingCandidates.push_back(y * XRES + x);
+				}
 			}
 			inBounds = true;
 		}
@@ -3428,12 +3589,93 @@ void Simulation::RecalcFreeParticles(bool do_life_dec)
 				continue;
 			}
 		}
+		if (t >= 0 && t < PT_NUM)
+			partsByType[t].push_back(i);
 	}
 	parts.Flatten();
 	if (elementRecount)
 		elementRecount = false;
 }
 
+static uint32_t SpreadBits(uint32_t v)
+{
+	v &= 0xFFFFU;
+	v = (v | (v << 8)) & 0x00FF00FFU;
+	v = (v | (v << 4)) & 0x0F0F0F0FU;
+	v = (v | (v << 2)) & 0x33333333U;
+	v = (v | (v << 1)) & 0x55555555U;
+	return v;
+}
+
+// Packs live particles into [0, NUM_PARTS) in Z-order of their positions, so that particles
+// that are close to each other in the simulation are also close to each other in memory.
+// Particles in the same position keep their relative order, so stacks are resolved the same
+// way. This changes particle IDs, so anything that refers to particles by ID is fixed up here;
+// pmap and photons are rebuilt by RecalcFreeParticles, which must be called right after this.
+void Simulation::SortParticles()
+{
+	FrameTime::Span span(frameTime, "Simulation::SortParticles");
+	struct SortItem
+	{
+		uint32_t key;
+		int id;
+	};
+	std::vector<SortItem> items;
+	items.reserve(parts.active);
+	for (int i = 0; i < parts.active; i++)
+	{
+		if (!parts[i].type)
+		{
+			continue;
+		}
+		auto x = std::clamp(int(parts[i].x+0.5f), 0, XRES-1);
+		auto y = std::clamp(int(parts[i].y+0.5f), 0, YRES-1);
+		items.push_back({ SpreadBits(x) | (SpreadBits(y) << 1), i });
+	}
+	std::stable_sort(items.begin(), items.end(), [](auto &lhs, auto &rhs) {
+		return lhs.key < rhs.key;
+	});
+
+	std::vector<int> newIDs(parts.active, -1);
+	std::vector<Particle> sorted(items.size());
+	for (auto k = 0; k < int(items.size()); k++)
+	{
+		newIDs[items[k].id] = k;
+		sorted[k] = parts[items[k].id];
+	}
+	auto newID = [&newIDs](int i) {
+		return (i >= 0 && i < int(newIDs.size())) ? newIDs[i] : -1;
+	};
+	for (auto &part : sorted)
+	{
+		if (part.type == PT_SOAP)
+		{
+			// same as in Simulation::Save, links to particles that are gone are dropped
+			if (part.ctype & 2)
+			{
+				part.tmp = newID(part.tmp);
+				if (part.tmp < 0)
+					part.ctype &= ~2;
+			}
+			if (part.ctype & 4)
+			{
+				part.tmp2 = newID(part.tmp2);
+				if (part.tmp2 < 0)
+					part.ctype &= ~4;
+			}
+		}
+	}
+	if (player.spawnID >= 0)
+		player.spawnID = newID(player.spawnID);
+	if (player2.spawnID >= 0)
+		player2.spawnID = newID(player2.spawnID);
+
+	std::copy(sorted.begin(), sorted.end(), parts.data.begin());
+	std::fill(parts.data.begin() + sorted.size(), parts.data.begin() + parts.active, Particle{});
+	parts.active = int(sorted.size());
+	parts.Flatten();
+}
+
 void Parts::Flatten()
 {
 	int newActive = 0;
@@ -3457,19 +3699,15 @@ void Parts::Flatten()
 void Simulation::SimulateGoL()
 {
 	auto &builtinGol = SimulationData::builtinGol;
+	auto &gol = this->gol.Get();
 	CGOL = 0;
-	for (int i = 0; i < parts.active; ++i)
-	{
+	ForEachPartOfType(PT_LIFE, [this, &builtinGol, &gol](int i) {
 		auto &part = parts[i];
-		if (part.type != PT_LIFE)
-		{
-			continue;
-		}
 		auto x = int(part.x + 0.5f);
 		auto y = int(part.y + 0.5f);
 		if (x < CELL || y < CELL || x >= XRES - CELL || y >= YRES - CELL)
 		{
-			continue;
+			return;
 		}
 		unsigned int golnum = part.ctype;
 		unsigned int ruleset = golnum;
@@ -3536,7 +3774,7 @@ void Simulation::SimulateGoL()
 				part.tmp2 -= 1;
 			}
 		}
-	}
+	});
 	for (int y = CELL; y < YRES - CELL; ++y)
 	{
 		for (int x = CELL; x < XRES - CELL; ++x)
@@ -3637,29 +3875,31 @@ void Simulation::CheckStacking()
 	auto &elements = sd.elements;
 	bool excessive_stacking_found = false;
 	force_stacking_check = false;
-	for (int y = 0; y < YRES; y++)
+	// Only cells that RecalcFreeParticles saw go over the threshold can be stacked; visit them in
+	// the order a sweep of the whole screen would, as each may use up a random number
+	std::sort(stackingCandidates.begin(), stackingCandidates.end());
+	for (auto cell : stackingCandidates)
 	{
-		for (int x = 0; x < XRES; x++)
+		int x = cell % XRES;
+		int y = cell / XRES;
+		// Use a threshold, since some particle stacking can be normal (e.g. BIZR + FILT)
+		// Setting pmap_count[y][x] > NPART means BHOL will form in that spot
+		if (pmap_count[y][x]>stackingThreshold)
 		{
-			// Use a threshold, since some particle stacking can be normal (e.g. BIZR + FILT)
-			// Setting pmap_count[y][x] > NPART means BHOL will form in that spot
-			if (pmap_count[y][x]>5)
+			if (bmap[y/CELL][x/CELL]==WL_EHOLE)
 			{
-				if (bmap[y/CELL][x/CELL]==WL_EHOLE)
-				{
-					// Allow more stacking in E-hole
-					if (pmap_count[y][x]>1500)
-					{
-						pmap_count[y][x] = pmap_count[y][x] + NPART;
-						excessive_stacking_found = 1;
-					}
-				}
-				else if (pmap_count[y][x]>1500 || (unsigned int)rng.between(0, 1599) <= (pmap_count[y][x]+100))
+				// Allow more stacking in E-hole
+				if (pmap_count[y][x]>1500)
 				{
 					pmap_count[y][x] = pmap_count[y][x] + NPART;
-					excessive_stacking_found = true;
+					excessive_stacking_found = 1;
 				}
 			}
+			else if (pmap_count[y][x]>1500 || (unsigned int)rng.between(0, 1599) <= (pmap_count[y][x]+100))
+			{
+				pmap_count[y][x] = pmap_count[y][x] + NPART;
+				excessive_stacking_found = true;
+			}
 		}
 	}
 	if (excessive_stacking_found)
@@ -3781,7 +4021,11 @@ void Simulation::BeforeSim(bool willUpdate)
 	}
 
 	if (debug_nextToUpdate == 0)
+	{
+		if (willUpdate && sortInterval > 0 && !(frameCount % sortInterval))
+			SortParticles();
 		RecalcFreeParticles(willUpdate);
+	}
 
 	if (willUpdate)
 	{
@@ -3807,6 +4051,8 @@ void Simulation::BeforeSim(bool willUpdate)
 		if (elementCount[PT_LOVE] > 0 || elementCount[PT_LOLZ] > 0)
 		{
 			int nx, nnx, ny, nny, r, rt;
+			auto &love = Element_LOVE_love.Get();
+			auto &lolz = Element_LOLZ_lolz.Get();
 			for (ny=0; ny<YRES-4; ny++)
 			{
 				for (nx=0; nx<XRES-4; nx++)
@@ -3820,11 +4066,11 @@ void Simulation::BeforeSim(bool willUpdate)
 						kill_part(ID(r));
 					else if (parts[ID(r)].type==PT_LOVE)
 					{
-						Element_LOVE_love[nx/9][ny/9] = 1;
+						love[nx/9][ny/9] = 1;
 					}
 					else if (parts[ID(r)].type==PT_LOLZ)
 					{
-						Element_LOLZ_lolz[nx/9][ny/9] = 1;
+						lolz[nx/9][ny/9] = 1;
 					}
 				}
 			}
@@ -3832,7 +4078,7 @@ void Simulation::BeforeSim(bool willUpdate)
 			{
 				for (ny=9; ny<=YRES-7; ny++)
 				{
-					if (Element_LOVE_love[nx/9][ny/9]==1)
+					if (love[nx/9][ny/9]==1)
 					{
 						for ( nnx=0; nnx<9; nnx++)
 							for ( nny=0; nny<9; nny++)
@@ -3849,8 +4095,8 @@ void Simulation::BeforeSim(bool willUpdate)
 								}
 							}
 					}
-					Element_LOVE_love[nx/9][ny/9]=0;
-					if (Element_LOLZ_lolz[nx/9][ny/9]==1)
+					love[nx/9][ny/9]=0;
+					if (lolz[nx/9][ny/9]==1)
 					{
 						for ( nnx=0; nnx<9; nnx++)
 							for ( nny=0; nny<9; nny++)
@@ -3868,7 +4114,7 @@ void Simulation::BeforeSim(bool willUpdate)
 								}
 							}
 					}
-					Element_LOLZ_lolz[nx/9][ny/9]=0;
+					lolz[nx/9][ny/9]=0;
 				}
 			}
 		}
@@ -3876,30 +4122,26 @@ void Simulation::BeforeSim(bool willUpdate)
 		// make WIRE work
 		if(elementCount[PT_WIRE] > 0)
 		{
-			for (int nx = 0; nx < XRES; nx++)
-			{
-				for (int ny = 0; ny < YRES; ny++)
-				{
-					int r = pmap[ny][nx];
-					if (!r)
-						continue;
-					if(parts[ID(r)].type == PT_WIRE)
-						parts[ID(r)].tmp = parts[ID(r)].ctype;
-				}
-			}
+			// only visit WIRE particles instead of sweeping the entire pmap; the pmap check
+			// keeps WIRE hidden under other particles out of it, as before
+			ForEachPartOfType(PT_WIRE, [this](int i) {
+				auto x = int(parts[i].x+0.5f);
+				auto y = int(parts[i].y+0.5f);
+				if (x<0 || y<0 || x>=XRES || y>=YRES)
+					return;
+				auto r = pmap[y][x];
+				if (r && ID(r) == i)
+					parts[i].tmp = parts[i].ctype;
+			});
 		}
 
 		// update PPIP tmp?
 		if (Element_PPIP_ppip_changed)
 		{
-			for (int i = 0; i < parts.active; i++)
-			{
-				if (parts[i].type==PT_PPIP)
-				{
-					parts[i].tmp |= (parts[i].tmp&0xE0000000)>>3;
-					parts[i].tmp &= ~0xE0000000;
-				}
-			}
+			ForEachPartOfType(PT_PPIP, [this](int i) {
+				parts[i].tmp |= (parts[i].tmp&0xE0000000)>>3;
+				parts[i].tmp &= ~0xE0000000;
+			});
 			Element_PPIP_ppip_changed = 0;
 		}
 
@@ -8,6 +8,7 @@
 #include "MenuSection.h"
 #include "AccessProperty.h"
 #include "CoordStack.h"
+#include "LazyArray.h"
 #include "common/tpt-rand.h"
 #include "gravity/Gravity.h"
 #include "graphics/RendererFrame.h"
@@ -18,6 +19,7 @@
 #include <cstddef>
 #include <vector>
 #include <array>
+#include <bitset>
 #include <memory>
 #include <optional>
 
@@ -135,21 +137,28 @@ public:
 	int lightningRecreate = 0;
 	bool gravWallChanged = false;
 
-	Particle portalp[CHANNELS][8][80];
+	LazyArray<Particle[CHANNELS][8][80]> portalp; // allocated when a particle first enters a portal
 	int wireless[CHANNELS][2];
 
 	int CGOL = 0;
 	int GSPEED = 1;
-	unsigned int gol[YRES][XRES][5];
+	int sortInterval = 0; // frames between SortParticles calls, 0 to never sort
+	LazyArray<unsigned int[YRES][XRES][5]> gol; // allocated by the first SimulateGoL
 
 	float fvx[YCELLS][XCELLS];
 	float fvy[YCELLS][XCELLS];
-	int Element_LOLZ_lolz[XRES/9][YRES/9];
-	int Element_LOVE_love[XRES/9][YRES/9];
+	LazyArray<int[XRES/9][YRES/9]> Element_LOLZ_lolz;
+	LazyArray<int[XRES/9][YRES/9]> Element_LOVE_love;
 	int Element_PSTN_tempParts[std::max(XRES, YRES)];
 	int Element_PPIP_ppip_changed;
+	// live particles of each type in ascending id order, collected by RecalcFreeParticles; a type is
+	// marked stale once a particle may have become of that type since, see ForEachPartOfType
+	std::array<std::vector<int>, PT_NUM> partsByType;
+	std::bitset<PT_NUM> partsByTypeStale;
 
 	unsigned int pmap_count[YRES][XRES];
+	static constexpr unsigned int stackingThreshold = 5;
+	std::vector<int> stackingCandidates; // cells whose pmap_count went over stackingThreshold, collected by RecalcFreeParticles
 
 	int edgeMode = EDGE_VOID;
 	int gravityMode = GRAV_VERTICAL;
@@ -175,9 +184,32 @@ public:
 	void Load(const GameSave *save, bool includePressure, Vec2<int> blockP); // block coordinates
 	std::unique_ptr<GameSave> Save(bool includePressure, Rect<int> partR); // particle coordinates
 	void SaveSimOptions(GameSave &gameSave);
+	void LoadSimOptions(const GameSave &gameSave);
 	SimulationSample GetSample(int x, int y);
 
-	std::unique_ptr<Snapshot> CreateSnapshot() const;
+	// Calls func with the id of every particle of type t, in ascending id order, the same way a
+	// loop over parts[0..active) that checks the type of each particle would. func must not turn
+	// other particles into type t.
+	template<class Func>
+	void ForEachPartOfType(int t, Func &&func)
+	{
+		if (partsByTypeStale[t])
+		{
+			for (int i = 0; i < parts.active; i++)
+			{
+				if (parts[i].type == t)
+					func(i);
+			}
+			return;
+		}
+		for (auto i : partsByType[t])
+		{
+			if (parts[i].type == t)
+				func(i);
+		}
+	}
+
+	std::unique_ptr<Snapshot> CreateSnapshot(const Snapshot *shareWith = nullptr) const;
 	void Restore(const Snapshot &snap);
 
 	int is_blocking(int t, int x, int y) const;
@@ -221,6 +253,7 @@ public:
 	virtual void UpdateParticles(int start, int end) = 0; // Dispatches an update to the range [start, end).
 	void SimulateGoL();
 	void RecalcFreeParticles(bool do_life_dec);
+	void SortParticles();
 	void CheckStacking();
 	void BeforeSim(bool willUpdate);
 	void AfterSim();
@@ -1,4 +1,8 @@
 #include "Snapshot.h"
+#include "tasks/TaskPool.h"
+#include <bit>
+#include <cstring>
+#include <functional>
 
 uint32_t Snapshot::Hash() const
 {
@@ -17,22 +21,28 @@ uint32_t Snapshot::Hash() const
 	auto takeVector = [&take](auto &vec) {
 		take(reinterpret_cast<const uint8_t *>(vec.data()), vec.size() * sizeof(vec[0]));
 	};
-	takeVector(AirPressure);
-	takeVector(AirVelocityX);
-	takeVector(AirVelocityY);
-	takeVector(AmbientHeat);
-	takeVector(Particles);
-	takeVector(GravMass);
-	takeVector(GravMask);
-	takeVector(GravForceX);
-	takeVector(GravForceY);
-	takeVector(BlockMap);
-	takeVector(ElecMap);
-	takeVector(BlockAir);
-	takeVector(BlockAirH);
-	takeVector(FanVelocityX);
-	takeVector(FanVelocityY);
-	takeVector(PortalParticles);
+	auto takePlane = [&take](auto &plane) {
+		for (auto t = 0U; t < plane.TileCount(); ++t)
+		{
+			take(reinterpret_cast<const uint8_t *>(plane.TileData(t)), plane.TileSize(t) * sizeof(plane[0]));
+		}
+	};
+	takePlane(AirPressure);
+	takePlane(AirVelocityX);
+	takePlane(AirVelocityY);
+	takePlane(AmbientHeat);
+	takePlane(Particles);
+	takePlane(GravMass);
+	takePlane(GravMask);
+	takePlane(GravForceX);
+	takePlane(GravForceY);
+	takePlane(BlockMap);
+	takePlane(ElecMap);
+	takePlane(BlockAir);
+	takePlane(BlockAirH);
+	takePlane(FanVelocityX);
+	takePlane(FanVelocityY);
+	takePlane(PortalParticles);
 	takeVector(WirelessData);
 	takeVector(stickmen);
 	takeThing(FrameCount);
@@ -41,3 +51,154 @@ uint32_t Snapshot::Hash() const
 	// signs and Authors are excluded on purpose, as they aren't POD and don't have much effect on the simulation.
 	return hash;
 }
+
+// * Hash64 is a faster alternative to Hash for checking whether two Snapshots are identical; the two
+//   are not related in any way. It is built on the XXH64 round function, see
+//   https://github.com/Cyan4973/xxHash/blob/dev/doc/xxhash_spec.md, and consumes 32 bytes
+//   per step rather than one. Each tile of each plane is hashed separately and the results are
+//   combined in a fixed order, so the result does not depend on whether planes are hashed in parallel.
+namespace
+{
+	constexpr uint64_t prime1 = UINT64_C(0x9E3779B185EBCA87);
+	constexpr uint64_t prime2 = UINT64_C(0xC2B2AE3D27D4EB4F);
+	constexpr uint64_t prime3 = UINT64_C(0x165667B19E3779F9);
+	constexpr uint64_t prime4 = UINT64_C(0x85EBCA77C2B2AE63);
+	constexpr uint64_t prime5 = UINT64_C(0x27D4EB2F165667C5);
+
+	uint64_t Read64(const uint8_t *data)
+	{
+		uint64_t value;
+		std::memcpy(&value, data, sizeof(value));
+		return value;
+	}
+
+	uint64_t Round(uint64_t acc, uint64_t input)
+	{
+		acc += input * prime2;
+		acc = std::rotl(acc, 31);
+		return acc * prime1;
+	}
+
+	uint64_t Merge(uint64_t acc, uint64_t value)
+	{
+		acc ^= Round(0, value);
+		return acc * prime1 + prime4;
+	}
+
+	uint64_t Avalanche(uint64_t hash)
+	{
+		hash ^= hash >> 33;
+		hash *= prime2;
+		hash ^= hash >> 29;
+		hash *= prime3;
+		hash ^= hash >> 32;
+		return hash;
+	}
+
+	uint64_t HashBytes(const uint8_t *data, size_t size, uint64_t seed)
+	{
+		auto *end = data + size;
+		uint64_t hash;
+		if (size >= 32)
+		{
+			uint64_t acc[4] = { seed + prime1 + prime2, seed + prime2, seed, seed - prime1 };
+			while (end - data >= 32)
+			{
+				// independent lanes, which the compiler is free to vectorize
+				for (auto l = 0; l < 4; ++l)
+				{
+					acc[l] = Round(acc[l], Read64(data + l * 8));
+				}
+				data += 32;
+			}
+			hash = std::rotl(acc[0], 1) + std::rotl(acc[1], 7) + std::rotl(acc[2], 12) + std::rotl(acc[3], 18);
+			for (auto l = 0; l < 4; ++l)
+			{
+				hash = Merge(hash, acc[l]);
+			}
+		}
+		else
+		{
+			hash = seed + prime5;
+		}
+		hash += size;
+		while (end - data >= 8)
+		{
+			hash ^= Round(0, Read64(data));
+			hash = std::rotl(hash, 27) * prime1 + prime4;
+			data += 8;
+		}
+		while (data < end)
+		{
+			hash ^= *data * prime5;
+			hash = std::rotl(hash, 11) * prime1;
+			data += 1;
+		}
+		return Avalanche(hash);
+	}
+
+	template<class Plane>
+	uint64_t HashPlane(const Plane &plane)
+	{
+		auto hash = Merge(prime5, plane.size());
+		for (auto t = 0U; t < plane.TileCount(); ++t)
+		{
+			hash = Merge(hash, HashBytes(reinterpret_cast<const uint8_t *>(plane.TileData(t)), plane.TileSize(t) * sizeof(plane[0]), t));
+		}
+		return hash;
+	}
+
+	template<class Item>
+	uint64_t HashVector(const std::vector<Item> &vec)
+	{
+		return Merge(HashBytes(reinterpret_cast<const uint8_t *>(vec.data()), vec.size() * sizeof(Item), 0), vec.size());
+	}
+}
+
+uint64_t Snapshot::Hash64(bool parallel) const
+{
+	std::vector<std::function<uint64_t ()>> parts = {
+		[this]() { return HashPlane(AirPressure); },
+		[this]() { return HashPlane(AirVelocityX); },
+		[this]() { return HashPlane(AirVelocityY); },
+		[this]() { return HashPlane(AmbientHeat); },
+		[this]() { return HashPlane(Particles); },
+		[this]() { return HashPlane(GravMass); },
+		[this]() { return HashPlane(GravMask); },
+		[this]() { return HashPlane(GravForceX); },
+		[this]() { return HashPlane(GravForceY); },
+		[this]() { return HashPlane(BlockMap); },
+		[this]() { return HashPlane(ElecMap); },
+		[this]() { return HashPlane(BlockAir); },
+		[this]() { return HashPlane(BlockAirH); },
+		[this]() { return HashPlane(FanVelocityX); },
+		[this]() { return HashPlane(FanVelocityY); },
+		[this]() { return HashPlane(PortalParticles); },
+		[this]() { return HashVector(WirelessData); },
+		[this]() { return HashVector(stickmen); },
+	};
+	std::vector<uint64_t> partHashes(parts.size());
+	if (parallel)
+	{
+		TaskPool::Ref().Parallel(int(parts.size()), [&parts, &partHashes](int i) {
+			partHashes[i] = parts[i]();
+		}, TaskPriority::normal);
+	}
+	else
+	{
+		for (auto i = 0U; i < parts.size(); ++i)
+		{
+			partHashes[i] = parts[i]();
+		}
+	}
+	auto hash = prime5;
+	for (auto partHash : partHashes)
+	{
+		hash = Merge(hash, partHash);
+	}
+	hash = Merge(hash, FrameCount);
+	hash = Merge(hash, RngState[0]);
+	hash = Merge(hash, RngState[1]);
+	// signs and Authors are excluded on purpose, see Hash.
+	return Avalanche(hash);
+}
@@ -2,6 +2,7 @@
 #include "Particle.h"
 #include "Sign.h"
 #include "Stickman.h"
+#include "SnapshotPlane.h"
 #include "common/tpt-rand.h"
 #include "common/Bson.h"
 #include <vector>
@@ -11,28 +12,30 @@
 class Snapshot
 {
 public:
-	std::vector<float> AirPressure;
-	std::vector<float> AirVelocityX;
-	std::vector<float> AirVelocityY;
-	std::vector<float> AmbientHeat;
+	using ParticlePlane = SnapshotPlane<Particle, 256>;
 
-	std::vector<Particle> Particles;
+	SnapshotPlane<float> AirPressure;
+	SnapshotPlane<float> AirVelocityX;
+	SnapshotPlane<float> AirVelocityY;
+	SnapshotPlane<float> AmbientHeat;
 
-	std::vector<float> GravForceX;
-	std::vector<float> GravForceY;
-	std::vector<float> GravMass;
-	std::vector<uint32_t> GravMask;
+	ParticlePlane Particles;
 
-	std::vector<unsigned char> BlockMap;
-	std::vector<unsigned char> ElecMap;
-	std::vector<unsigned char> BlockAir;
-	std::vector<unsigned char> BlockAirH;
+	SnapshotPlane<float> GravForceX;
+	SnapshotPlane<float> GravForceY;
+	SnapshotPlane<float> GravMass;
+	SnapshotPlane<uint32_t> GravMask;
 
-	std::vector<float> FanVelocityX;
-	std::vector<float> FanVelocityY;
+	SnapshotPlane<unsigned char> BlockMap;
+	SnapshotPlane<unsigned char> ElecMap;
+	SnapshotPlane<unsigned char> BlockAir;
+	SnapshotPlane<unsigned char> BlockAirH;
 
+	SnapshotPlane<float> FanVelocityX;
+	SnapshotPlane<float> FanVelocityY;
 
-	std::vector<Particle> PortalParticles;
+
+	ParticlePlane PortalParticles;
 	std::vector<int> WirelessData;
 	std::vector<playerst> stickmen;
 	std::vector<sign> signs;
@@ -41,6 +44,7 @@ public:
 	RNG::State RngState;
 
 	uint32_t Hash() const;
+	uint64_t Hash64(bool parallel = false) const;
 
 	Bson Authors;
 
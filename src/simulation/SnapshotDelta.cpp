@@ -1,5 +1,7 @@
 #include "SnapshotDelta.h"
 #include <algorithm>
+#include <cstring>
+#include <type_traits>
 #include <utility>
 
 // * A SnapshotDelta is a bidirectional difference type between Snapshots, defined such
@@ -117,13 +119,32 @@ bool operator ==(const std::vector<sign> &lhs, const std::vector<sign> &rhs)
 	return true;
 }
 
+constexpr size_t BlockBytes = 64;
+
+// * Compares BlockBytes bytes at a time in 64-bit words; the loop has no early exit so that it can be
+//   vectorized, which is where the gain over comparing items one by one comes from.
+inline bool BlockEqual(const void *lhs, const void *rhs)
+{
+	auto *lhsBytes = static_cast<const unsigned char *>(lhs);
+	auto *rhsBytes = static_cast<const unsigned char *>(rhs);
+	uint64_t acc = 0;
+	for (auto i = 0U; i < BlockBytes; i += sizeof(uint64_t))
+	{
+		uint64_t lhsWord, rhsWord;
+		std::memcpy(&lhsWord, lhsBytes + i, sizeof(uint64_t));
+		std::memcpy(&rhsWord, rhsBytes + i, sizeof(uint64_t));
+		acc |= lhsWord ^ rhsWord;
+	}
+	return !acc;
+}
+
 template<class Item>
-void FillHunkVectorPtr(const Item *oldItems, const Item *newItems, SnapshotDelta::HunkVector<Item> &out, size_t size)
+void FillHunkVectorPtr(const Item *oldItems, const Item *newItems, SnapshotDelta::HunkVector<Item> &out, size_t size, size_t baseOffset = 0)
 {
 	auto i = 0U;
 	bool different = false;
 	auto offset = 0U;
-	auto markDifferent = [oldItems, newItems, &out, &i, &different, &offset](bool mark) {
+	auto markDifferent = [oldItems, newItems, &out, &i, &different, &offset, baseOffset](bool mark) {
 		if (mark && !different)
 		{
 			different = true;
@@ -135,7 +156,7 @@ void FillHunkVectorPtr(const Item *oldItems, const Item *newItems, SnapshotDelta
 			auto size = i - offset;
 			out.emplace_back();
 			auto &hunk = out.back();
-			hunk.offset = offset;
+			hunk.offset = baseOffset + offset;
 			auto &diffs = hunk.diffs;
 			diffs.resize(size);
 			for (auto j = 0U; j < size; ++j)
@@ -147,6 +168,24 @@ void FillHunkVectorPtr(const Item *oldItems, const Item *newItems, SnapshotDelta
 	};
 	while (i < size)
 	{
+		if constexpr (std::is_arithmetic_v<Item>)
+		{
+			// * Outside hunks, skip whole blocks of bitwise identical items. This only ever skips items
+			//   that operator == would also consider identical, except for identical NaNs, which need
+			//   not be restored anyway.
+			if (!different)
+			{
+				constexpr auto blockItems = BlockBytes / sizeof(Item);
+				while (size - i >= blockItems && BlockEqual(oldItems + i, newItems + i))
+				{
+					i += blockItems;
+				}
+				if (i == size)
+				{
+					break;
+				}
+			}
+		}
 		markDifferent(!(oldItems[i] == newItems[i]));
 		i += 1U;
 	}
@@ -159,6 +198,30 @@ void FillHunkVector(const std::vector<Item> &oldItems, const std::vector<Item> &
 	FillHunkVectorPtr<Item>(oldItems.data(), newItems.data(), out, std::min(oldItems.size(), newItems.size()));
 }
 
+// * Same as FillHunkVector, but for SnapshotPlanes, whose items may be diffed as a stream of some
+//   smaller type, see Particles below. Tiles shared by the two planes are known to be identical and
+//   are skipped. Hunks never span tile boundaries, which is fine, they are just a bit more numerous.
+template<class Item, class PlaneItem, size_t TileItems>
+void FillHunkVectorPlane(const SnapshotPlane<PlaneItem, TileItems> &oldPlane, const SnapshotPlane<PlaneItem, TileItems> &newPlane, SnapshotDelta::HunkVector<Item> &out, size_t commonSize)
+{
+	constexpr auto itemsPerPlaneItem = sizeof(PlaneItem) / sizeof(Item);
+	for (auto t = 0U; t * TileItems < commonSize; ++t)
+	{
+		if (oldPlane.SharesTile(newPlane, t))
+		{
+			continue;
+		}
+		auto size = std::min(TileItems, commonSize - t * TileItems);
+		FillHunkVectorPtr(reinterpret_cast<const Item *>(oldPlane.TileData(t)), reinterpret_cast<const Item *>(newPlane.TileData(t)), out, size * itemsPerPlaneItem, t * TileItems * itemsPerPlaneItem);
+	}
+}
+
+template<class Item>
+void FillHunkVectorPlane(const SnapshotPlane<Item> &oldPlane, const SnapshotPlane<Item> &newPlane, SnapshotDelta::HunkVector<Item> &out)
+{
+	FillHunkVectorPlane<Item>(oldPlane, newPlane, out, std::min(oldPlane.size(), newPlane.size()));
+}
+
 template<class Item>
 void FillSingleDiff(const Item &oldItem, const Item &newItem, SnapshotDelta::SingleDiff<Item> &out)
 {
@@ -190,6 +253,29 @@ void ApplyHunkVector(const SnapshotDelta::HunkVector<Item> &in, std::vector<Item
 	ApplyHunkVectorPtr<UseOld, Item>(in, items.data());
 }
 
+template<bool UseOld, class Item, class PlaneItem, size_t TileItems>
+void ApplyHunkVectorPlane(const SnapshotDelta::HunkVector<Item> &in, SnapshotPlane<PlaneItem, TileItems> &plane)
+{
+	constexpr auto itemsPerTile = TileItems * sizeof(PlaneItem) / sizeof(Item);
+	for (auto &hunk : in)
+	{
+		auto offset = hunk.offset;
+		auto &diffs = hunk.diffs;
+		auto j = 0U;
+		while (j < diffs.size())
+		{
+			auto t = (offset + j) / itemsPerTile;
+			auto tileBegin = t * itemsPerTile;
+			auto *items = reinterpret_cast<Item *>(plane.MutableTile(t));
+			auto end = std::min(size_t(diffs.size()), tileBegin + itemsPerTile - offset);
+			for (; j < end; ++j)
+			{
+				items[offset + j - tileBegin] = UseOld ? diffs[j].oldItem : diffs[j].newItem;
+			}
+		}
+	}
+}
+
 template<bool UseOld, class Item>
 void ApplySingleDiff(const SnapshotDelta::SingleDiff<Item> &in, Item &item)
 {
@@ -203,105 +289,96 @@ std::unique_ptr<SnapshotDelta> SnapshotDelta::FromSnapshots(const Snapshot &oldS
 {
 	auto ptr = std::make_unique<SnapshotDelta>();
 	auto &delta = *ptr;
-	FillHunkVector(oldSnap.AirPressure    , newSnap.AirPressure    , delta.AirPressure    );
-	FillHunkVector(oldSnap.AirVelocityX   , newSnap.AirVelocityX   , delta.AirVelocityX   );
-	FillHunkVector(oldSnap.AirVelocityY   , newSnap.AirVelocityY   , delta.AirVelocityY   );
-	FillHunkVector(oldSnap.AmbientHeat    , newSnap.AmbientHeat    , delta.AmbientHeat    );
-	FillHunkVector(oldSnap.GravMass       , newSnap.GravMass       , delta.GravMass       );
-	FillHunkVector(oldSnap.GravMask       , newSnap.GravMask       , delta.GravMask       );
-	FillHunkVector(oldSnap.GravForceX     , newSnap.GravForceX     , delta.GravForceX     );
-	FillHunkVector(oldSnap.GravForceY     , newSnap.GravForceY     , delta.GravForceY     );
-	FillHunkVector(oldSnap.BlockMap       , newSnap.BlockMap       , delta.BlockMap       );
-	FillHunkVector(oldSnap.ElecMap        , newSnap.ElecMap        , delta.ElecMap        );
-	FillHunkVector(oldSnap.BlockAir       , newSnap.BlockAir       , delta.BlockAir       );
-	FillHunkVector(oldSnap.BlockAirH      , newSnap.BlockAirH      , delta.BlockAirH      );
-	FillHunkVector(oldSnap.FanVelocityX   , newSnap.FanVelocityX   , delta.FanVelocityX   );
-	FillHunkVector(oldSnap.FanVelocityY   , newSnap.FanVelocityY   , delta.FanVelocityY   );
+	FillHunkVectorPlane(oldSnap.AirPressure    , newSnap.AirPressure    , delta.AirPressure    );
+	FillHunkVectorPlane(oldSnap.AirVelocityX   , newSnap.AirVelocityX   , delta.AirVelocityX   );
+	FillHunkVectorPlane(oldSnap.AirVelocityY   , newSnap.AirVelocityY   , delta.AirVelocityY   );
+	FillHunkVectorPlane(oldSnap.AmbientHeat    , newSnap.AmbientHeat    , delta.AmbientHeat    );
+	FillHunkVectorPlane(oldSnap.GravMass       , newSnap.GravMass       , delta.GravMass       );
+	FillHunkVectorPlane(oldSnap.GravMask       , newSnap.GravMask       , delta.GravMask       );
+	FillHunkVectorPlane(oldSnap.GravForceX     , newSnap.GravForceX     , delta.GravForceX     );
+	FillHunkVectorPlane(oldSnap.GravForceY     , newSnap.GravForceY     , delta.GravForceY     );
+	FillHunkVectorPlane(oldSnap.BlockMap       , newSnap.BlockMap       , delta.BlockMap       );
+	FillHunkVectorPlane(oldSnap.ElecMap        , newSnap.ElecMap        , delta.ElecMap        );
+	FillHunkVectorPlane(oldSnap.BlockAir       , newSnap.BlockAir       , delta.BlockAir       );
+	FillHunkVectorPlane(oldSnap.BlockAirH      , newSnap.BlockAirH      , delta.BlockAirH      );
+	FillHunkVectorPlane(oldSnap.FanVelocityX   , newSnap.FanVelocityX   , delta.FanVelocityX   );
+	FillHunkVectorPlane(oldSnap.FanVelocityY   , newSnap.FanVelocityY   , delta.FanVelocityY   );
 	FillHunkVector(oldSnap.WirelessData   , newSnap.WirelessData   , delta.WirelessData   );
 	FillSingleDiff(oldSnap.signs          , newSnap.signs          , delta.signs          );
 	FillSingleDiff(oldSnap.Authors        , newSnap.Authors        , delta.Authors        );
 	FillSingleDiff(oldSnap.FrameCount     , newSnap.FrameCount     , delta.FrameCount     );
 	FillSingleDiff(oldSnap.RngState       , newSnap.RngState       , delta.RngState       );
-	FillHunkVectorPtr(reinterpret_cast<const uint32_t *>(oldSnap.PortalParticles.data()), reinterpret_cast<const uint32_t *>(newSnap.PortalParticles.data()), delta.PortalParticles, newSnap.PortalParticles.size() * ParticleUint32Count);
+	FillHunkVectorPlane(oldSnap.PortalParticles, newSnap.PortalParticles, delta.PortalParticles, newSnap.PortalParticles.size());
 	FillHunkVectorPtr(reinterpret_cast<const uint32_t *>(oldSnap.stickmen.data())       , reinterpret_cast<const uint32_t *>(newSnap.stickmen.data()       ), delta.stickmen       , newSnap.stickmen       .size() * playerstUint32Count);
 
 	// * Slightly more interesting; this will only diff the common parts, the rest is copied separately.
 	auto commonSize = std::min(oldSnap.Particles.size(), newSnap.Particles.size());
-	FillHunkVectorPtr(reinterpret_cast<const uint32_t *>(oldSnap.Particles.data()), reinterpret_cast<const uint32_t *>(newSnap.Particles.data()), delta.commonParticles, commonSize * ParticleUint32Count);
+	FillHunkVectorPlane(oldSnap.Particles, newSnap.Particles, delta.commonParticles, commonSize);
 	delta.extraPartsOld.resize(oldSnap.Particles.size() - commonSize);
-	std::copy(oldSnap.Particles.begin() + commonSize, oldSnap.Particles.end(), delta.extraPartsOld.begin());
+	oldSnap.Particles.CopyTo(delta.extraPartsOld.data(), commonSize, oldSnap.Particles.size());
 	delta.extraPartsNew.resize(newSnap.Particles.size() - commonSize);
-	std::copy(newSnap.Particles.begin() + commonSize, newSnap.Particles.end(), delta.extraPartsNew.begin());
+	newSnap.Particles.CopyTo(delta.extraPartsNew.data(), commonSize, newSnap.Particles.size());
 
 	return ptr;
 }
 
-std::unique_ptr<Snapshot> SnapshotDelta::Forward(const Snapshot &oldSnap)
+template<bool UseOld>
+void ApplySnapshotDelta(const SnapshotDelta &delta, Snapshot &snap)
 {
-	auto ptr = std::make_unique<Snapshot>(oldSnap);
-	auto &newSnap = *ptr;
-	ApplyHunkVector<false>(AirPressure    , newSnap.AirPressure    );
-	ApplyHunkVector<false>(AirVelocityX   , newSnap.AirVelocityX   );
-	ApplyHunkVector<false>(AirVelocityY   , newSnap.AirVelocityY   );
-	ApplyHunkVector<false>(AmbientHeat    , newSnap.AmbientHeat    );
-	ApplyHunkVector<false>(GravMass       , newSnap.GravMass       );
-	ApplyHunkVector<false>(GravMask       , newSnap.GravMask       );
-	ApplyHunkVector<false>(GravForceX     , newSnap.GravForceX     );
-	ApplyHunkVector<false>(GravForceY     , newSnap.GravForceY     );
-	ApplyHunkVector<false>(BlockMap       , newSnap.BlockMap       );
-	ApplyHunkVector<false>(ElecMap        , newSnap.ElecMap        );
-	ApplyHunkVector<false>(BlockAir       , newSnap.BlockAir       );
-	ApplyHunkVector<false>(BlockAirH      , newSnap.BlockAirH      );
-	ApplyHunkVector<false>(FanVelocityX   , newSnap.FanVelocityX   );
-	ApplyHunkVector<false>(FanVelocityY   , newSnap.FanVelocityY   );
-	ApplyHunkVector<false>(WirelessData   , newSnap.WirelessData   );
-	ApplySingleDiff<false>(signs          , newSnap.signs          );
-	ApplySingleDiff<false>(Authors        , newSnap.Authors        );
-	ApplySingleDiff<false>(FrameCount     , newSnap.FrameCount     );
-	ApplySingleDiff<false>(RngState       , newSnap.RngState       );
-	ApplyHunkVectorPtr<false>(PortalParticles, reinterpret_cast<uint32_t *>(newSnap.PortalParticles.data()));
-	ApplyHunkVectorPtr<false>(stickmen       , reinterpret_cast<uint32_t *>(newSnap.stickmen.data()       ));
+	ApplyHunkVectorPlane<UseOld>(delta.AirPressure    , snap.AirPressure    );
+	ApplyHunkVectorPlane<UseOld>(delta.AirVelocityX   , snap.AirVelocityX   );
+	ApplyHunkVectorPlane<UseOld>(delta.AirVelocityY   , snap.AirVelocityY   );
+	ApplyHunkVectorPlane<UseOld>(delta.AmbientHeat    , snap.AmbientHeat    );
+	ApplyHunkVectorPlane<UseOld>(delta.GravMass       , snap.GravMass       );
+	ApplyHunkVectorPlane<UseOld>(delta.GravMask       , snap.GravMask       );
+	ApplyHunkVectorPlane<UseOld>(delta.GravForceX     , snap.GravForceX     );
+	ApplyHunkVectorPlane<UseOld>(delta.GravForceY     , snap.GravForceY     );
+	ApplyHunkVectorPlane<UseOld>(delta.BlockMap       , snap.BlockMap       );
+	ApplyHunkVectorPlane<UseOld>(delta.ElecMap        , snap.ElecMap        );
+	ApplyHunkVectorPlane<UseOld>(delta.BlockAir       , snap.BlockAir       );
+	ApplyHunkVectorPlane<UseOld>(delta.BlockAirH      , snap.BlockAirH      );
+	ApplyHunkVectorPlane<UseOld>(delta.FanVelocityX   , snap.FanVelocityX   );
+	ApplyHunkVectorPlane<UseOld>(delta.FanVelocityY   , snap.FanVelocityY   );
+	ApplyHunkVector<UseOld>(delta.WirelessData   , snap.WirelessData   );
+	ApplySingleDiff<UseOld>(delta.signs          , snap.signs          );
+	ApplySingleDiff<UseOld>(delta.Authors        , snap.Authors        );
+	ApplySingleDiff<UseOld>(delta.FrameCount     , snap.FrameCount     );
+	ApplySingleDiff<UseOld>(delta.RngState       , snap.RngState       );
+	ApplyHunkVectorPlane<UseOld>(delta.PortalParticles, snap.PortalParticles);
+	ApplyHunkVectorPtr<UseOld>(delta.stickmen       , reinterpret_cast<uint32_t *>(snap.stickmen.data()       ));
 
 	// * Slightly more interesting; apply the common hunk vector, copy the extra portion separaterly.
-	ApplyHunkVectorPtr<false>(commonParticles, reinterpret_cast<uint32_t *>(newSnap.Particles.data()));
-	auto commonSize = oldSnap.Particles.size() - extraPartsOld.size();
-	newSnap.Particles.resize(commonSize + extraPartsNew.size());
-	std::copy(extraPartsNew.begin(), extraPartsNew.end(), newSnap.Particles.begin() + commonSize);
+	ApplyHunkVectorPlane<UseOld>(delta.commonParticles, snap.Particles);
+	auto &extraPartsFrom = UseOld ? delta.extraPartsNew : delta.extraPartsOld;
+	auto &extraPartsTo   = UseOld ? delta.extraPartsOld : delta.extraPartsNew;
+	auto commonSize = snap.Particles.size() - extraPartsFrom.size();
+	snap.Particles.Resize(commonSize + extraPartsTo.size());
+	snap.Particles.CopyFrom(commonSize, extraPartsTo.data(), extraPartsTo.size());
+}
 
+std::unique_ptr<Snapshot> SnapshotDelta::Forward(const Snapshot &oldSnap) const
+{
+	auto ptr = std::make_unique<Snapshot>(oldSnap);
+	ForwardInPlace(*ptr);
 	return ptr;
 }
 
-std::unique_ptr<Snapshot> SnapshotDelta::Restore(const Snapshot &newSnap)
+std::unique_ptr<Snapshot> SnapshotDelta::Restore(const Snapshot &newSnap) const
 {
 	auto ptr = std::make_unique<Snapshot>(newSnap);
-	auto &oldSnap = *ptr;
-	ApplyHunkVector<true>(AirPressure    , oldSnap.AirPressure    );
-	ApplyHunkVector<true>(AirVelocityX   , oldSnap.AirVelocityX   );
-	ApplyHunkVector<true>(AirVelocityY   , oldSnap.AirVelocityY   );
-	ApplyHunkVector<true>(AmbientHeat    , oldSnap.AmbientHeat    );
-	ApplyHunkVector<true>(GravMass       , oldSnap.GravMass       );
-	ApplyHunkVector<true>(GravMask       , oldSnap.GravMask       );
-	ApplyHunkVector<true>(GravForceX     , oldSnap.GravForceX     );
-	ApplyHunkVector<true>(GravForceY     , oldSnap.GravForceY     );
-	ApplyHunkVector<true>(BlockMap       , oldSnap.BlockMap       );
-	ApplyHunkVector<true>(ElecMap        , oldSnap.ElecMap        );
-	ApplyHunkVector<true>(BlockAir       , oldSnap.BlockAir       );
-	ApplyHunkVector<true>(BlockAirH      , oldSnap.BlockAirH      );
-	ApplyHunkVector<true>(FanVelocityX   , oldSnap.FanVelocityX   );
-	ApplyHunkVector<true>(FanVelocityY   , oldSnap.FanVelocityY   );
-	ApplyHunkVector<true>(WirelessData   , oldSnap.WirelessData   );
-	ApplySingleDiff<true>(signs          , oldSnap.signs          );
-	ApplySingleDiff<true>(Authors        , oldSnap.Authors        );
-	ApplySingleDiff<true>(FrameCount     , oldSnap.FrameCount     );
-	ApplySingleDiff<true>(RngState       , oldSnap.RngState       );
-	ApplyHunkVectorPtr<true>(PortalParticles, reinterpret_cast<uint32_t *>(oldSnap.PortalParticles.data()));
-	ApplyHunkVectorPtr<true>(stickmen       , reinterpret_cast<uint32_t *>(oldSnap.stickmen.data()       ));
+	RestoreInPlace(*ptr);
+	return ptr;
+}
 
-	// * Slightly more interesting; apply the common hunk vector, copy the extra portion separaterly.
-	ApplyHunkVectorPtr<true>(commonParticles, reinterpret_cast<uint32_t *>(oldSnap.Particles.data()));
-	auto commonSize = newSnap.Particles.size() - extraPartsNew.size();
-	oldSnap.Particles.resize(commonSize + extraPartsOld.size());
-	std::copy(extraPartsOld.begin(), extraPartsOld.end(), oldSnap.Particles.begin() + commonSize);
+// * These are the same as Forward and Restore, but they turn the Snapshot passed to them into the
+//   result rather than copying it first. Stepping GameModel::historyCurrent this way only touches
+//   the data covered by the SnapshotDelta.
+void SnapshotDelta::ForwardInPlace(Snapshot &snap) const
+{
+	ApplySnapshotDelta<false>(*this, snap);
+}
 
-	return ptr;
+void SnapshotDelta::RestoreInPlace(Snapshot &snap) const
+{
+	ApplySnapshotDelta<true>(*this, snap);
 }
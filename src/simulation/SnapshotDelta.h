@@ -73,6 +73,8 @@ struct SnapshotDelta
 	SingleDiff<Bson> Authors;
 
 	static std::unique_ptr<SnapshotDelta> FromSnapshots(const Snapshot &oldSnap, const Snapshot &newSnap);
-	std::unique_ptr<Snapshot> Forward(const Snapshot &oldSnap);
-	std::unique_ptr<Snapshot> Restore(const Snapshot &newSnap);
+	std::unique_ptr<Snapshot> Forward(const Snapshot &oldSnap) const;
+	std::unique_ptr<Snapshot> Restore(const Snapshot &newSnap) const;
+	void ForwardInPlace(Snapshot &snap) const;
+	void RestoreInPlace(Snapshot &snap) const;
 };
@@ -0,0 +1,164 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+// * A SnapshotPlane holds one of the big fields of a Snapshot as a sequence of fixed-size, reference-
+//   counted tiles. Copying a SnapshotPlane only copies tile pointers, and Assign reuses the tiles of a
+//   base SnapshotPlane wherever their contents are identical to the data being stored, so consecutive
+//   Snapshots of a mostly static simulation share most of their memory. SnapshotDelta::FromSnapshots
+//   also skips shared tiles without looking at their contents.
+// * Tiles are never modified while shared: MutableTile copies a shared tile before handing it out.
+// * Items are compared with memcmp, so Item must not have padding bytes.
+template<class Item, size_t TileItems = 1024>
+class SnapshotPlane
+{
+	using Tile = std::array<Item, TileItems>;
+	std::vector<std::shared_ptr<Tile>> tiles;
+	size_t itemCount = 0;
+
+	static const std::shared_ptr<Tile> &ZeroTile()
+	{
+		static const auto zeroTile = std::make_shared<Tile>();
+		return zeroTile;
+	}
+
+public:
+	static constexpr size_t tileItems = TileItems;
+
+	size_t size() const
+	{
+		return itemCount;
+	}
+
+	size_t TileCount() const
+	{
+		return tiles.size();
+	}
+
+	// number of items in use in tile t; all tiles but the last are full
+	size_t TileSize(size_t t) const
+	{
+		return std::min(TileItems, itemCount - t * TileItems);
+	}
+
+	const Item *TileData(size_t t) const
+	{
+		return tiles[t]->data();
+	}
+
+	Item *MutableTile(size_t t)
+	{
+		if (tiles[t].use_count() > 1)
+		{
+			tiles[t] = std::make_shared<Tile>(*tiles[t]);
+		}
+		return tiles[t]->data();
+	}
+
+	// whether every tile is the shared all-zero tile, as after Assign(nullptr, ...); only tile pointers are compared,
+	// so tiles that merely happen to hold zeroes don't count
+	bool AllZeroTiles() const
+	{
+		return std::all_of(tiles.begin(), tiles.end(), [](auto &tile) {
+			return tile == ZeroTile();
+		});
+	}
+
+	bool SharesTile(const SnapshotPlane &other, size_t t) const
+	{
+		return t < tiles.size() && t < other.tiles.size() && tiles[t] == other.tiles[t] && TileSize(t) == other.TileSize(t);
+	}
+
+	// data may be nullptr, in which case the plane reads as all zeroes without anything being read
+	// or allocated: every tile is the same shared all-zero tile
+	void Assign(const Item *data, size_t newItemCount, const SnapshotPlane *base = nullptr)
+	{
+		itemCount = newItemCount;
+		tiles.resize((itemCount + TileItems - 1) / TileItems);
+		for (auto t = 0U; t < tiles.size(); ++t)
+		{
+			if (!data)
+			{
+				tiles[t] = ZeroTile();
+				continue;
+			}
+			auto count = TileSize(t);
+			auto *src = data + t * TileItems;
+			if (base && t < base->tiles.size() && base->TileSize(t) == count && !std::memcmp(base->TileData(t), src, count * sizeof(Item)))
+			{
+				tiles[t] = base->tiles[t];
+				continue;
+			}
+			auto tile = std::make_shared<Tile>();
+			std::copy(src, src + count, tile->begin());
+			tiles[t] = std::move(tile);
+		}
+	}
+
+	// new items are value-initialized
+	void Resize(size_t newItemCount)
+	{
+		auto oldItemCount = itemCount;
+		auto oldTileCount = tiles.size();
+		itemCount = newItemCount;
+		tiles.resize((itemCount + TileItems - 1) / TileItems);
+		if (newItemCount > oldItemCount && oldItemCount % TileItems)
+		{
+			auto t = oldItemCount / TileItems;
+			auto *tile = MutableTile(t);
+			std::fill(tile + oldItemCount % TileItems, tile + TileItems, Item{});
+		}
+		for (auto t = oldTileCount; t < tiles.size(); ++t)
+		{
+			tiles[t] = std::make_shared<Tile>();
+		}
+	}
+
+	Item operator [](size_t i) const
+	{
+		return (*tiles[i / TileItems])[i % TileItems];
+	}
+
+	void CopyTo(Item *out, size_t begin, size_t end) const
+	{
+		while (begin < end)
+		{
+			auto t = begin / TileItems;
+			auto from = begin % TileItems;
+			auto count = std::min(TileItems - from, end - begin);
+			std::copy(TileData(t) + from, TileData(t) + from + count, out);
+			out += count;
+			begin += count;
+		}
+	}
+
+	void CopyTo(Item *out) const
+	{
+		CopyTo(out, 0, itemCount);
+	}
+
+	void CopyFrom(size_t begin, const Item *data, size_t count)
+	{
+		auto end = begin + count;
+		while (begin < end)
+		{
+			auto t = begin / TileItems;
+			auto from = begin % TileItems;
+			auto n = std::min(TileItems - from, end - begin);
+			std::copy(data, data + n, MutableTile(t) + from);
+			data += n;
+			begin += n;
+		}
+	}
+
+	std::vector<Item> ToVector() const
+	{
+		std::vector<Item> vec(itemCount);
+		CopyTo(vec.data());
+		return vec;
+	}
+};
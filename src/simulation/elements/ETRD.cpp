@@ -142,9 +142,8 @@ int Element_ETRD_nearestSparkablePart(Simulation *sim, int targetId)
 		// If neighbor search didn't find a suitable particle, search all particles
 		if (foundI < 0)
 		{
-			for (int i = 0; i < sim->parts.active; i++)
-			{
-				if (parts[i].type == PT_ETRD && !parts[i].life)
+			sim->ForEachPartOfType(PT_ETRD, [&](int i) {
+				if (!parts[i].life)
 				{
 					ui::Point checkPos = ui::Point(int(parts[i].x)-targetPos.X, int(parts[i].y)-targetPos.Y);
 					int checkDistance = int(std::hypot(checkPos.X, checkPos.Y));
@@ -154,16 +153,15 @@ int Element_ETRD_nearestSparkablePart(Simulation *sim, int targetId)
 						foundI = i;
 					}
 				}
-			}
+			});
 		}
 	}
 	else
 	{
 		// Recalculate countLife0, and search for the closest suitable particle
 		int countLife0 = 0;
-		for (int i = 0; i < sim->parts.active; i++)
-		{
-			if (parts[i].type == PT_ETRD && !parts[i].life)
+		sim->ForEachPartOfType(PT_ETRD, [&](int i) {
+			if (!parts[i].life)
 			{
 				countLife0++;
 				ui::Point checkPos = ui::Point(int(parts[i].x)-targetPos.X, int(parts[i].y)-targetPos.Y);
@@ -174,7 +172,7 @@ int Element_ETRD_nearestSparkablePart(Simulation *sim, int targetId)
 					foundI = i;
 				}
 			}
-		}
+		});
 		sim->etrd_life0_count = countLife0;
 		sim->etrd_count_valid = true;
 	}
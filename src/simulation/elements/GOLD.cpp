@@ -51,8 +51,8 @@ void Element::Element_GOLD()
 
 static int update(UPDATE_FUNC_ARGS)
 {
-	static int checkCoordsX[] = { -4, 4, 0, 0 };
-	static int checkCoordsY[] = { 0, 0, -4, 4 };
+	static const int checkCoordsX[] = { -4, 4, 0, 0 };
+	static const int checkCoordsY[] = { 0, 0, -4, 4 };
 	//Find nearby rusted iron (BMTL with tmp 1+)
 	for(int j = 0; j < 8; j++)
 	{
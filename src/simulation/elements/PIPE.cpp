@@ -450,6 +450,7 @@ static void props_pipe_to_part(const Particle *pipe, Particle *part, bool STOR)
 void Element_PIPE_transfer_pipe_to_part(Simulation * sim, Particle *pipe, Particle *part, bool STOR)
 {
 	props_pipe_to_part(pipe, part, STOR);
+	sim->partsByTypeStale[part->type] = true;
 	if (STOR)
 	{
 		pipe->tmp = 0;
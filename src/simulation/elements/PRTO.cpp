@@ -76,6 +76,8 @@ static int update(UPDATE_FUNC_ARGS)
 				for (auto nnx =0 ; nnx<80; nnx++)
 				{
 					int randomness = (count + sim->rng.between(-1, 1) + 4) % 8;//add -1,0,or 1 to count
+					if (!sim->portalp.Allocated())
+						continue; // nothing has entered a portal yet, and reading through operator [] would allocate portalp
 					if (sim->portalp[parts[i].tmp][randomness][nnx].type==PT_SPRK)// TODO: make it look better, spark creation
 					{
 						sim->create_part(-1,x+1,y,PT_SPRK);
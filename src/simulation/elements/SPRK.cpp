@@ -207,14 +207,18 @@ static int update(UPDATE_FUNC_ARGS)
 					continue;
 				auto receiver = TYP(r);
 				auto sender = ct;
-				auto pavg = sim->parts_avg(ID(r), i,PT_INSL);
+				// parts_avg is not free and most neighbours never get this far, so only look for insulation when it matters
+				auto insulated = [&]() {
+					auto pavg = sim->parts_avg(ID(r), i,PT_INSL);
+					return pavg == PT_INSL || pavg == PT_RSSS;
+				};
 				//receiver is the element SPRK is trying to conduct to
 				//sender is the element the SPRK is on
 				//First, some checks usually for (de)activation of elements
 				switch (receiver)
 				{
 				case PT_SWCH:
-					if (pavg!=PT_INSL && pavg!=PT_RSSS && parts[i].life<4)
+					if (parts[i].life<4 && !insulated())
 					{
 						if(sender==PT_PSCN && parts[ID(r)].life<10) {
 							parts[ID(r)].life = 10;
@@ -227,7 +231,7 @@ static int update(UPDATE_FUNC_ARGS)
 					}
 					break;
 				case PT_SPRK:
-					if (pavg!=PT_INSL && pavg!=PT_RSSS && parts[i].life<4)
+					if (parts[i].life<4 && !insulated())
 					{
 						if (parts[ID(r)].ctype==PT_SWCH)
 						{
@@ -260,14 +264,14 @@ static int update(UPDATE_FUNC_ARGS)
 					}
 					continue;
 				case PT_PPIP:
-					if (parts[i].life == 3 && pavg!=PT_INSL && pavg!=PT_RSSS)
+					if (parts[i].life == 3 && !insulated())
 					{
 						if (sender == PT_NSCN || sender == PT_PSCN || sender == PT_INST)
 							Element_PPIP_flood_trigger(sim, x+rx, y+ry, sender);
 					}
 					continue;
 				case PT_NTCT: case PT_PTCT: case PT_INWR:
-					if (sender==PT_METL && pavg!=PT_INSL && pavg!=PT_RSSS && parts[i].life<4)
+					if (sender==PT_METL && parts[i].life<4 && !insulated())
 					{
 						parts[ID(r)].temp = 473.0f;
 						if (receiver==PT_NTCT||receiver==PT_PTCT)
@@ -286,9 +290,9 @@ static int update(UPDATE_FUNC_ARGS)
 					continue;
 				}
 
-				if ((pavg == PT_INSL) || (pavg == PT_RSSS)) continue; //Insulation blocks everything past here
 				if (!((elements[receiver].Properties&PROP_CONDUCTS)||receiver==PT_INST||receiver==PT_QRTZ)) continue; //Stop non-conducting receivers, allow INST and QRTZ as special cases
 				if (abs(rx)+abs(ry)>=4 &&sender!=PT_SWCH&&receiver!=PT_SWCH) continue; //Only switch conducts really far
+				if (insulated()) continue; //Insulation blocks everything past here
 
 				auto tryConduct = [&]() {
 					if (receiver==sender && receiver!=PT_INST && receiver!=PT_QRTZ) return true; //Everything conducts to itself, except INST.
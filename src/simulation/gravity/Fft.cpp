@@ -24,7 +24,10 @@ constexpr auto scaleFactor = -float(M_GRAV) / (NCELL * 4);
 static_assert(sizeof(std::complex<float>) == sizeof(fftwf_complex));
 struct FftwArrayDeleter        { void operator ()(float               ptr[]) const { fftwf_free(ptr);         } };
 struct FftwComplexArrayDeleter { void operator ()(std::complex<float> ptr[]) const { fftwf_free(ptr);         } };
-struct FftwPlanDeleter         { void operator ()(fftwf_plan          ptr  ) const { fftwf_destroy_plan(ptr); } };
+// the FFTW planner is not thread-safe, only fftwf_execute is, so plans of Simulations running on
+// different threads must be created and destroyed under this lock
+static std::mutex fftwPlannerMx;
+struct FftwPlanDeleter         { void operator ()(fftwf_plan          ptr  ) const { std::lock_guard lk(fftwPlannerMx); fftwf_destroy_plan(ptr); } };
 using  FftwArrayPtr        = std::unique_ptr<float                              [], FftwArrayDeleter       >;
 using  FftwComplexArrayPtr = std::unique_ptr<std::complex<float>                [], FftwComplexArrayDeleter>;
 using  FftwPlanPtr         = std::unique_ptr<std::remove_pointer<fftwf_plan>::type, FftwPlanDeleter        >;
@@ -149,6 +152,7 @@ void GravityImpl::Init()
 	forceXBigT = FftwComplexArray(transSize);
 	forceYBigT = FftwComplexArray(transSize);
 
+	std::unique_lock plannerLk(fftwPlannerMx);
 	massForward = FftwPlanPtr(fftwf_plan_dft_r2c_2d(blocks.Y, blocks.X, massBig.get(), reinterpret_cast<fftwf_complex *>(massBigT.get()), fftwPlanFlags));
 	forceXInverse = FftwPlanPtr(fftwf_plan_dft_c2r_2d(blocks.Y, blocks.X, reinterpret_cast<fftwf_complex *>(forceXBigT.get()), forceXBig.get(), fftwPlanFlags));
 	forceYInverse = FftwPlanPtr(fftwf_plan_dft_c2r_2d(blocks.Y, blocks.X, reinterpret_cast<fftwf_complex *>(forceYBigT.get()), forceYBig.get(), fftwPlanFlags));
@@ -157,6 +161,7 @@ void GravityImpl::Init()
 	auto kernelYRaw = FftwArray(blocks.X * blocks.Y);
 	auto kernelXForward = FftwPlanPtr(fftwf_plan_dft_r2c_2d(blocks.Y, blocks.X, kernelXRaw.get(), reinterpret_cast<fftwf_complex *>(kernelXT.get()), fftwPlanFlags));
 	auto kernelYForward = FftwPlanPtr(fftwf_plan_dft_r2c_2d(blocks.Y, blocks.X, kernelYRaw.get(), reinterpret_cast<fftwf_complex *>(kernelYT.get()), fftwPlanFlags));
+	plannerLk.unlock();
 	auto kernelX = MakePlane<blocks.X, blocks.Y>(blocks, kernelXRaw.get());
 	auto kernelY = MakePlane<blocks.X, blocks.Y>(blocks, kernelYRaw.get());
 	//calculate velocity map caused by a point mass
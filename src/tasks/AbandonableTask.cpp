@@ -2,6 +2,18 @@
 
 void AbandonableTask::doWork_wrapper()
 {
+	bool abandonedEarly;
+	{
+		std::lock_guard<std::mutex> g(taskMutex);
+		abandonedEarly = thAbandoned;
+	}
+	if (abandonedEarly)
+	{
+		// Abandoned while waiting in the TaskPool, so nobody wants the result. thDone is
+		// still false, so Abandon has left deleting the AbandonableTask to us.
+		delete this;
+		return;
+	}
 	Task::doWork_wrapper();
 	done_cv.notify_one();
 
@@ -12,7 +12,7 @@ void Task::AddTaskListener(TaskListener * listener)
 void Task::Start()
 {
 	before();
-	std::thread([this]() { doWork_wrapper(); }).detach();
+	TaskPool::Ref().Schedule([this]() { doWork_wrapper(); }, priority);
 }
 
 int Task::GetProgress()
@@ -1,6 +1,6 @@
 #pragma once
 #include "common/String.h"
-#include <thread>
+#include "TaskPool.h"
 #include <mutex>
 
 class TaskListener;
@@ -32,6 +32,7 @@ protected:
 
 	TaskListener *listener;
 	std::mutex taskMutex;
+	TaskPriority priority = TaskPriority::normal;
 
 	virtual void before();
 	virtual void after();
@@ -0,0 +1,118 @@
+#include "TaskPool.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+
+TaskPool::TaskPool()
+{
+	// some Tasks spend most of their time waiting on the network, so allow a few workers even on
+	// machines with few cores
+	maxWorkers = std::clamp(int(std::thread::hardware_concurrency()), 4, 8);
+}
+
+TaskPool &TaskPool::Ref()
+{
+	// never destroyed, see the comment on TaskPool
+	static auto *pool = new TaskPool();
+	return *pool;
+}
+
+void TaskPool::Schedule(std::function<void ()> job, TaskPriority priority)
+{
+	bool startWorker = false;
+	{
+		std::lock_guard lk(queuesMx);
+		queues[int(priority)].push_back(std::move(job));
+		if (!idleWorkers && workers < maxWorkers)
+		{
+			workers += 1;
+			startWorker = true;
+		}
+	}
+	if (startWorker)
+	{
+		std::thread([this]() { Work(); }).detach();
+	}
+	else
+	{
+		queuesCv.notify_one();
+	}
+}
+
+void TaskPool::Work()
+{
+	while (true)
+	{
+		std::function<void ()> job;
+		{
+			std::unique_lock lk(queuesMx);
+			auto queueWithJob = [this]() {
+				return std::find_if(queues.begin(), queues.end(), [](auto &queue) {
+					return !queue.empty();
+				});
+			};
+			idleWorkers += 1;
+			queuesCv.wait(lk, [this, &queueWithJob]() {
+				return queueWithJob() != queues.end();
+			});
+			idleWorkers -= 1;
+			auto &queue = *queueWithJob();
+			job = std::move(queue.front());
+			queue.pop_front();
+		}
+		job();
+	}
+}
+
+void TaskPool::Parallel(int count, std::function<void (int)> func, TaskPriority priority)
+{
+	if (count <= 1)
+	{
+		if (count == 1)
+		{
+			func(0);
+		}
+		return;
+	}
+	// shared with the scheduled jobs, which may only get to run after this has returned, in which
+	// case they find no indices left and do nothing
+	struct State
+	{
+		std::function<void (int)> func;
+		int count;
+		std::atomic<int> next = 0;
+		std::mutex doneMx;
+		std::condition_variable doneCv;
+		int done = 0;
+	};
+	auto state = std::make_shared<State>();
+	state->func = std::move(func);
+	state->count = count;
+	auto run = [state]() {
+		while (true)
+		{
+			auto index = state->next++;
+			if (index >= state->count)
+			{
+				break;
+			}
+			state->func(index);
+			std::lock_guard lk(state->doneMx);
+			if (++state->done == state->count)
+			{
+				state->doneCv.notify_all();
+			}
+		}
+	};
+	auto helpers = std::min(count - 1, maxWorkers);
+	for (int i = 0; i < helpers; i++)
+	{
+		Schedule(run, priority);
+	}
+	run();
+	std::unique_lock lk(state->doneMx);
+	state->doneCv.wait(lk, [&state]() {
+		return state->done == state->count;
+	});
+}
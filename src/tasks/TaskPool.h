@@ -0,0 +1,45 @@
+#pragma once
+#include <array>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+
+enum class TaskPriority
+{
+	high,
+	normal,
+	low,
+};
+
+// A bounded set of worker threads that Tasks are run on, instead of one thread per Task.
+// Jobs of higher priority are started first, jobs of the same priority in the order they were
+// scheduled. Workers are started as needed, up to a limit, and are never stopped; like the
+// detached threads this replaces, they don't hold up process exit.
+// There is one shared queue rather than per-worker deques with work-stealing. Jobs do fan out
+// through Parallel, but its caller takes indices itself instead of waiting on other workers to
+// pick them up, so a job waiting for its subtasks never needs a free worker and the pool can't
+// deadlock on them; stealing would only change which thread runs an index.
+class TaskPool
+{
+	std::mutex queuesMx;
+	std::condition_variable queuesCv;
+	std::array<std::deque<std::function<void ()>>, 3> queues; // indexed by TaskPriority
+	int workers = 0;
+	int idleWorkers = 0;
+	int maxWorkers;
+
+	TaskPool();
+	void Work();
+
+public:
+	static TaskPool &Ref();
+
+	void Schedule(std::function<void ()> job, TaskPriority priority);
+
+	// Calls func(0) through func(count - 1) spread over the calling thread and the workers, and
+	// returns once all calls have returned. The calling thread keeps taking indices for itself
+	// rather than only waiting, so this finishes even if every worker is busy, and is safe to
+	// call from a job that is itself running on the pool.
+	void Parallel(int count, std::function<void (int)> func, TaskPriority priority);
+};